@@ -4,10 +4,13 @@
 #include "Batch.h"
 // ospray_sg
 #include "sg/Frame.h"
+#include "sg/Profiler.h"
+#include "sg/exporter/TiledImageExporter.h"
 #include "sg/fb/FrameBuffer.h"
 #include "sg/importer/Importer.h"
 #include "sg/renderer/MaterialRegistry.h"
 #include "sg/visitors/Commit.h"
+#include "sg/visitors/MemoryUsage.h"
 #include "sg/visitors/PrintNodes.h"
 #include "sg/camera/Camera.h"
 // rkcommon
@@ -38,6 +41,12 @@ void BatchContext::start()
       std::cout << "..rendering animation!" << std::endl;
       renderAnimation();
     }
+    if (optMemoryUsage) {
+      sg::MemoryUsage usage;
+      frame->traverse(usage);
+      baseMaterialRegistry->traverse(usage);
+      usage.print(std::cout);
+    }
     std::cout << "...finished!" << std::endl;
     sg::clearAssets();
   }
@@ -147,6 +156,15 @@ bool BatchContext::parseCommandLine()
         optGridSize = vec3i(x, y, z);
         optGridEnable = true;
       }
+    } else if (switchArg == "-t" || switchArg == "--tiles") {
+      if (argAvailability(switchArg, 2)) {
+        auto x = max(0, atoi(argv[argIndex++]));
+        auto y = max(0, atoi(argv[argIndex++]));
+        optTileSize = vec2i(x, y);
+      }
+    } else if (switchArg == "-to" || switchArg == "--tileOverlap") {
+      if (argAvailability(switchArg, 1))
+        optTileOverlap = max(0, atoi(argv[argIndex++]));
     } else if (switchArg == "-a" || switchArg == "--albedo") {
       saveAlbedo = true;
     } else if (switchArg == "-d" || switchArg == "--depth") {
@@ -157,6 +175,10 @@ bool BatchContext::parseCommandLine()
       saveLayers = true;
     } else if (switchArg == "-m" || switchArg == "--metadata") {
       saveMetaData = true;
+    } else if (switchArg == "-mem" || switchArg == "--memoryUsage") {
+      optMemoryUsage = true;
+    } else if (switchArg == "--dedupMaterials") {
+      baseMaterialRegistry->deduplicate = true;
     } else if (switchArg == "-fps" || switchArg == "--speed") {
       if (argAvailability(switchArg, 1))
         fps = atoi(argv[argIndex++]);
@@ -175,6 +197,12 @@ bool BatchContext::parseCommandLine()
         std::cout
             << "using default ospray camera, to use imported definition camera indices begins from 1"
             << std::endl;
+    } else if (switchArg == "-ac" || switchArg == "--allCameras") {
+      optAllCameras = true;
+    } else if (switchArg == "-cp" || switchArg == "--cameraPath") {
+      if (argAvailability(switchArg, 1))
+        optCameraPathStep = max(0.0, atof(argv[argIndex++]));
+      optAllCameras = true;
     } else if (switchArg == "-rn" || switchArg == "--range") {
       if (argAvailability(switchArg, 2)) {
         auto x = atoi(argv[argIndex++]);
@@ -198,28 +226,37 @@ bool BatchContext::parseCommandLine()
 }
 
 void BatchContext::render()
+{
+  setupFrame();
+  forEachCamera([&]() { renderFrame(); });
+}
+
+void BatchContext::setupFrame()
 {
   frame->createChild("renderer", "renderer_" + optRendererTypeStr);
-  if (cameraDef <= cameras.size() && cameraDef > 0) {
-    // simply adding a new camera to frame does not work
-    auto newCamera = cameras[cameraDef - 1]->nodeAs<sg::Camera>();
-    auto &camera =
-        frame->createChildAs<sg::Camera>("camera", newCamera->subType());
-    for (auto &c : newCamera->children())
-      camera.add(c.second);
-  } else  {
+  if (cameraDef <= cameras.size() && cameraDef > 0)
+    useImportedCamera(cameraDef - 1);
+  else {
     std::cout << "No cameras imported or invalid camera index specified" << std::endl;
     frame->createChild("camera", "camera_" + optCameraTypeStr);
   }
-  
+
   baseMaterialRegistry->updateMaterialList(optRendererTypeStr);
 
   lightsManager->updateWorld(frame->childAs<sg::World>("world"));
 
   frame->child("renderer")
       .createChildData("material", baseMaterialRegistry->cppMaterialList);
-  // Set the frame "windowSize", it will create the right sized framebuffer
-  frame->child("windowSize") = optImageSize;
+  // Set the frame "windowSize", it will create the right sized framebuffer.
+  // Tiled rendering only ever needs a tile sized one.
+  if (optTileSize.x > 0 && optTileSize.y > 0) {
+    optTileSize = min(optTileSize, optImageSize);
+    if (optTileOverlap < 0)
+      optTileOverlap = optDenoiser ? 32 : 0;
+    frame->child("windowSize") =
+        min(optTileSize + 2 * optTileOverlap, optImageSize);
+  } else
+    frame->child("windowSize") = optImageSize;
 
   if (optPF >= 0)
     frame->child("renderer").createChild("pixelFilter", "int", optPF);
@@ -237,10 +274,10 @@ void BatchContext::render()
     frame->child("world").child("saveMetaData").setValue(true);
 
   if (optGridEnable) {
-    // Determine world bounds to calculate grid offsets
+    // Determine model bounds to calculate grid offsets
+    box3f bounds = importedModels->bounds();
     frame->child("world").remove(importedModels);
 
-    box3f bounds = frame->child("world").bounds();
     float tx = bounds.size().x * 1.2f;
     float ty = bounds.size().y * 1.2f;
     float tz = bounds.size().z * 1.2f;
@@ -264,37 +301,99 @@ void BatchContext::render()
 
   std::ifstream cams("cams.json");
   if (cams) {
-    std::vector<CameraState> cameraStack;
     JSON j;
     cams >> j;
     cameraStack = j.get<std::vector<CameraState>>();
-    CameraState cs = cameraStack.front();
-    arcballCamera->setState(cs);
+    if (!cameraStack.empty()) {
+      CameraState cs = cameraStack.front();
+      arcballCamera->setState(cs);
+    }
   }
 
   updateCamera();
 
-  auto &camera = frame->child("camera");
-  if (camera.hasChild("aspect"))
-    camera["aspect"] = optImageSize.x / (float)optImageSize.y;
+  setupCamera();
 
   if (cmdlCam) {
+    auto &camera = frame->child("camera");
     camera["position"] = pos;
     camera["direction"] = normalize(gaze - pos);
     camera["up"] = up;
   }
 
+  frame->child("navMode") = false;
+
+  frame->child("renderer").child("pixelSamples").setValue(optSPP);
+}
+
+void BatchContext::useImportedCamera(size_t index)
+{
+  // simply adding a new camera to frame does not work
+  auto newCamera = cameras[index]->nodeAs<sg::Camera>();
+  auto &camera =
+      frame->createChildAs<sg::Camera>("camera", newCamera->subType());
+  for (auto &c : newCamera->children())
+    camera.add(c.second);
+}
+
+void BatchContext::setupCamera()
+{
+  auto &camera = frame->child("camera");
+  if (camera.hasChild("aspect"))
+    camera["aspect"] = optImageSize.x / (float)optImageSize.y;
+
   if(camera.hasChild("stereoMode"))
   camera["stereoMode"] = optStereoMode;
 
   if(camera.hasChild("interpupillaryDistance"))
   camera["interpupillaryDistance"] = optInterpupillaryDistance;
+}
 
-  frame->child("navMode") = false;
+void BatchContext::forEachCamera(const std::function<void()> &renderView)
+{
+  if (!optAllCameras) {
+    renderView();
+    return;
+  }
 
-  frame->child("renderer").child("pixelSamples").setValue(optSPP);
+  // Only the camera changes between views, the committed world is reused
+  char suffix[16];
+  int numViews = 0;
+
+  for (size_t i = 0; i < cameras.size(); i++) {
+    useImportedCamera(i);
+    setupCamera();
+    std::snprintf(suffix, 16, ".camera%03zu", i + 1);
+    cameraSuffix = suffix;
+    fileNumber = framesRange.lower;
+    renderView();
+    numViews++;
+  }
 
-  renderFrame();
+  auto views = optCameraPathStep > 0.f
+      ? buildPath(cameraStack, optCameraPathStep)
+      : cameraStack;
+  if (!views.empty()) {
+    frame->createChild("camera", "camera_" + optCameraTypeStr);
+    setupCamera();
+    for (size_t i = 0; i < views.size(); i++) {
+      arcballCamera->setState(views[i]);
+      updateCamera();
+      std::snprintf(suffix, 16, ".view%04zu", i);
+      cameraSuffix = suffix;
+      fileNumber = framesRange.lower;
+      renderView();
+      numViews++;
+    }
+  }
+
+  cameraSuffix = "";
+
+  if (!numViews) {
+    std::cout << "No imported cameras or cams.json views, "
+                 "rendering the current camera" << std::endl;
+    renderView();
+  }
 }
 
 void BatchContext::renderFrame()
@@ -306,25 +405,162 @@ void BatchContext::renderFrame()
   if (studioCommon.denoiserAvailable && optDenoiser)
     frame->denoiseFB = true;
   frame->immediatelyWait = true;
-  frame->startNewFrame();
 
-  static int filenum = framesRange.lower;
+  const bool tiled = optTileSize.x > 0 && optTileSize.y > 0;
+  if (!tiled)
+    frame->startNewFrame();
+
+  if (fileNumber < 0)
+    fileNumber = framesRange.lower;
   char filenumber[8];
   std::string filename;
   if (!forceRewrite)
     do {
-      std::snprintf(filenumber, 8, ".%05d.", filenum++);
-      filename = optImageName + filenumber + optImageFormat;
+      std::snprintf(filenumber, 8, ".%05d.", fileNumber++);
+      filename = optImageName + cameraSuffix + filenumber + optImageFormat;
     } while (std::ifstream(filename.c_str()).good());
   else {
-    std::snprintf(filenumber, 8, ".%05d.", filenum++);
-    filename = optImageName + filenumber + optImageFormat;
+    std::snprintf(filenumber, 8, ".%05d.", fileNumber++);
+    filename = optImageName + cameraSuffix + filenumber + optImageFormat;
   }
 
   int screenshotFlags = saveMetaData << 4 | saveLayers << 3
       | saveNormal << 2 | saveDepth << 1 | saveAlbedo;
 
-  frame->saveFrame(filename, screenshotFlags);
+  if (tiled)
+    renderTiles(filename, screenshotFlags);
+  else
+    frame->saveFrame(filename, screenshotFlags);
+}
+
+void BatchContext::renderTiles(const std::string &filename, int flags)
+{
+  auto exporter = getTiledExporter(rkcommon::FileName(filename));
+  if (exporter == "") {
+    std::cout << "No tiled exporter found for type "
+              << rkcommon::FileName(filename).ext() << std::endl;
+    return;
+  }
+  auto exp = createNodeAs<TiledImageExporter>("exporter", exporter);
+  exp->child("file") = filename;
+
+  auto &fb = frame->childAs<sg::FrameBuffer>("framebuffer");
+  auto &camera = frame->child("camera");
+
+  // Every tile is rendered with the same framebuffer.  Tiles are grown by
+  // the overlap so the denoiser sees past their borders, then shifted back
+  // inside the image at its edges so the framebuffer size never changes.
+  const vec2i imageSize = optImageSize;
+  const vec2i tileSize = optTileSize;
+  const vec2i fbSize = min(tileSize + 2 * optTileOverlap, imageSize);
+
+  const bool albedo = flags & 0b1;
+  const bool depth = flags & 0b10;
+  const bool normal = flags & 0b100;
+  const bool metaData = flags & 0b10000;
+
+  if (!exp->begin(imageSize, tileSize, flags))
+    return;
+
+  if (metaData)
+    fb.resetPickIds();
+
+  // Tile buffers, rows from the top as exporters expect them
+  const size_t tilePixels = tileSize.x * tileSize.y;
+  std::vector<vec4f> colorTile(tilePixels);
+  std::vector<vec3f> albedoTile(albedo ? tilePixels : 0);
+  std::vector<float> depthTile(depth ? tilePixels : 0);
+  std::vector<vec3f> normalTile(normal ? tilePixels : 0);
+  std::vector<uint32_t> geomIdTile(metaData ? tilePixels : 0);
+  std::vector<uint32_t> instIdTile(metaData ? tilePixels : 0);
+  std::vector<vec3f> worldPosTile(metaData ? tilePixels : 0);
+
+  const int numTiles = ((imageSize.x + tileSize.x - 1) / tileSize.x)
+      * ((imageSize.y + tileSize.y - 1) / tileSize.y);
+  int tileIndex = 0;
+
+  for (int y = 0; y < imageSize.y; y += tileSize.y) {
+    for (int x = 0; x < imageSize.x; x += tileSize.x) {
+      ImageTile tile;
+      tile.origin = vec2i(x, y);
+      tile.size = min(tileSize, imageSize - tile.origin);
+
+      // Rendered region, rows from the top
+      vec2i start =
+          max(min(tile.origin - optTileOverlap, imageSize - fbSize), vec2i(0));
+      vec2i end = start + fbSize;
+
+      // OSPRay's image region starts at the bottom left corner
+      camera["imageStart"] = vec2f(float(start.x) / imageSize.x,
+          float(imageSize.y - end.y) / imageSize.y);
+      camera["imageEnd"] = vec2f(float(end.x) / imageSize.x,
+          float(imageSize.y - start.y) / imageSize.y);
+
+      std::cout << "tile " << ++tileIndex << "/" << numTiles << std::endl;
+      frame->startNewFrame();
+
+      // Copy the tile out of the framebuffer, which has rows from the bottom
+      auto cropTile = [&](const void *src, void *dst, size_t pixelBytes) {
+        for (int row = 0; row < tile.size.y; row++) {
+          const int fbRow = fbSize.y - 1 - (tile.origin.y + row - start.y);
+          const size_t fbIndex = fbRow * fbSize.x + tile.origin.x - start.x;
+          std::memcpy((char *)dst + row * tile.size.x * pixelBytes,
+              (const char *)src + fbIndex * pixelBytes,
+              tile.size.x * pixelBytes);
+        }
+      };
+
+      tile.floatColor = fb.isFloatFormat();
+      auto color = fb.map(OSP_FB_COLOR);
+      cropTile(color, colorTile.data(), tile.floatColor ? 16 : 4);
+      fb.unmap(color);
+      tile.color = colorTile.data();
+
+      if (albedo) {
+        auto buf = fb.map(OSP_FB_ALBEDO);
+        cropTile(buf, albedoTile.data(), sizeof(vec3f));
+        fb.unmap(buf);
+        tile.albedo = albedoTile.data();
+      }
+      if (depth) {
+        auto buf = fb.map(OSP_FB_DEPTH);
+        cropTile(buf, depthTile.data(), sizeof(float));
+        fb.unmap(buf);
+        tile.depth = depthTile.data();
+      }
+      if (normal) {
+        auto buf = fb.map(OSP_FB_NORMAL);
+        cropTile(buf, normalTile.data(), sizeof(vec3f));
+        fb.unmap(buf);
+        tile.normal = normalTile.data();
+      }
+      if (metaData) {
+        fb.pickIds();
+        if (fb.geomData && fb.instData && fb.worldPosData) {
+          cropTile(fb.geomData, geomIdTile.data(), sizeof(uint32_t));
+          cropTile(fb.instData, instIdTile.data(), sizeof(uint32_t));
+          cropTile(fb.worldPosData, worldPosTile.data(), sizeof(vec3f));
+          tile.geomId = geomIdTile.data();
+          tile.instId = instIdTile.data();
+          tile.worldPosition = worldPosTile.data();
+        }
+      }
+
+      if (!exp->writeTile(tile)) {
+        std::cerr << "Failed to write tile, aborting " << filename
+                  << std::endl;
+        break;
+      }
+    }
+  }
+
+  exp->end();
+
+  if (metaData)
+    fb.savePickIds(filename);
+
+  camera["imageStart"] = vec2f(0.f);
+  camera["imageEnd"] = vec2f(1.f);
 }
 
 void BatchContext::renderAnimation()
@@ -339,11 +575,12 @@ void BatchContext::renderAnimation()
   }
   animationTime += 1e-6;
 
-  while (time <= animationTime) {
-    animationManager->update(time);
-    renderFrame();
-    time += step;
-  }
+  forEachCamera([&]() {
+    for (float t = time; t <= animationTime; t += step) {
+      animationManager->update(t);
+      renderFrame();
+    }
+  });
 }
 
 void BatchContext::refreshScene(bool resetCam)
@@ -401,6 +638,7 @@ void BatchContext::importFiles(sg::NodePtr world)
         sgScene = true;
       } else {
         std::cout << "Importing: " << file << std::endl;
+        SG_PROFILE_SCOPE("importScene", file);
 
         auto importer = sg::getImporter(world, file);
         if (importer) {
@@ -441,11 +679,23 @@ ospStudio batch specific parameters:
    -cam  --camera 
          In case of mulitple imported cameras specify which camera definition to use, counting starts from 1
          0 here would use default camera implementation
+   -ac   --allCameras
+         render every imported camera and every cams.json view in one run,
+         image names get a .cameraNNN or .viewNNNN suffix
+   -cp   --cameraPath [step] for eg : 0.1
+         like --allCameras, with the cams.json views interpolated into a
+         path, step is the fraction between two views
    -a    --albedo
    -d    --depth
    -n    --normal
    -m    --metadata
    -l    --layers
+   -mem  --memoryUsage
+         print the memory held by the scene, by node type and largest
+         subtrees, after rendering
+         --dedupMaterials
+         share one material between imports whose materials and
+         textures are identical
    -f    --format (default png)
           format for saving the image
           (sg, exr, hdr, jpg, pfm,png, ppm)
@@ -467,7 +717,13 @@ ospStudio batch specific parameters:
    -sm    --stereoMode 0=none, 1=left, 2=right, 3=side-by-side, 4=top-bottom
    -id    --interpupillaryDistance
    -g     --grid [x y z] (default 1 1 1, single instance)
-            instace a grid of models)text"
+            instace a grid of models
+   -t     --tiles [x y] (default off)
+            render the image in tiles of this size, streamed to the
+            output file (png, exr) to bound memory use; png only
+            saves the color layer, use exr for the other layers
+   -to    --tileOverlap [int] (default 32 with the denoiser, else 0)
+            pixels rendered around each tile)text"
             << std::endl;
   if (studioCommon.denoiserAvailable) {
     std::cout <<
@@ -12,6 +12,7 @@
 #include "sg/renderer/MaterialRegistry.h"
 // Plugin
 #include <chrono>
+#include <functional>
 #include "AnimationManager.h"
 #include "PluginManager.h"
 #include "sg/scene/Animation.h"
@@ -34,8 +35,17 @@ class BatchContext : public StudioContext
   void updateCamera() override;
   void setCameraState(CameraState &cs) override;
   void render();
+  // Renderer, materials, lights and camera for the imported scene
+  void setupFrame();
   void renderFrame();
   void renderAnimation();
+  void renderTiles(const std::string &filename, int flags);
+
+  void useImportedCamera(size_t index);
+  void setupCamera();
+  // Calls renderView once per camera, or per camera and view with
+  // --allCameras, setting the matching image name suffix
+  void forEachCamera(const std::function<void()> &renderView);
 
  protected:
   PluginManager pluginManager;
@@ -49,6 +59,8 @@ class BatchContext : public StudioContext
   int optPF                      = -1; // use default
   int optDenoiser                = 0;
   bool optGridEnable             = false;
+  vec2i optTileSize              = {0, 0}; // 0 = render the whole image
+  int optTileOverlap             = -1; // default, only overlap when denoising
   vec3i optGridSize              = {1, 1, 1};
   // XXX should be OSPStereoMode, but for that we need 'uchar' Nodes
   int optStereoMode               = 0;
@@ -60,6 +72,7 @@ class BatchContext : public StudioContext
   bool saveNormal{false};
   bool saveLayers{false};
   bool saveMetaData{false};
+  bool optMemoryUsage{false};
   std::string optImageFormat{"png"};
   bool animate{false};
   int fps{24};
@@ -67,6 +80,13 @@ class BatchContext : public StudioContext
   range1i framesRange{0, 0};
   void printHelp() override;
   int cameraDef{0};
+  bool optAllCameras{false};
+  float optCameraPathStep{0.f}; // > 0 interpolates the cams.json views
+
+  // views loaded from cams.json
+  std::vector<CameraState> cameraStack;
+  std::string cameraSuffix;
+  int fileNumber{-1};
 
   std::shared_ptr<AnimationManager> animationManager{nullptr};
 
@@ -0,0 +1,471 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Benchmark.h"
+// ospray_sg
+#include "sg/fb/FrameBuffer.h"
+#include "sg/generator/Generator.h"
+#include "sg/importer/Importer.h"
+#include "sg/visitors/MemoryUsage.h"
+// rkcommon
+#include "rkcommon/utility/SaveImage.h"
+// json
+#include "sg/JSONDefs.h"
+// std
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static const std::vector<std::string> defaultScenes = {
+    "generator_tutorial_scene",
+    "generator_random_spheres",
+    "generator_wavelet",
+    "generator_unstructured_volume",
+    "generator_torus_volume",
+    "generator_sphere"};
+
+static const std::vector<std::string> defaultRenderers = {
+    "scivis", "pathtracer", "ao"};
+
+// Helper functions /////////////////////////////////////////////////////////
+
+static double msSince(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+static bool isGenerator(const std::string &scene)
+{
+  return scene.rfind("generator_", 0) == 0;
+}
+
+// Name used in the results and for the reference image
+static std::string sceneLabel(const std::string &scene)
+{
+  if (isGenerator(scene))
+    return scene.substr(std::string("generator_").size());
+  return rkcommon::FileName(scene).name();
+}
+
+static double peakRssMB()
+{
+#ifdef _WIN32
+  return 0.0; // not measured
+#else
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+  return usage.ru_maxrss / 1024.0; // kilobytes
+#endif
+#endif
+}
+
+// Reads the binary PPM written by rkcommon::utility::writePPM, rows from the
+// top
+static bool readPPM(
+    const std::string &fileName, vec2i &size, std::vector<uint8_t> &rgb)
+{
+  std::ifstream in(fileName, std::ios::binary);
+  std::string magic;
+  int maxValue = 0;
+  in >> magic >> size.x >> size.y >> maxValue;
+  in.get(); // single whitespace before the pixels
+  if (!in || magic != "P6" || maxValue != 255)
+    return false;
+
+  rgb.resize(3 * size_t(size.x) * size.y);
+  in.read((char *)rgb.data(), rgb.size());
+  return bool(in);
+}
+
+// BenchmarkContext definitions /////////////////////////////////////////////
+
+BenchmarkContext::BenchmarkContext(StudioCommon &_common)
+    : BatchContext(_common)
+{
+  // Time a fixed amount of work per frame
+  optSPP = 1;
+}
+
+void BenchmarkContext::start()
+{
+  std::cerr << "Benchmark mode\n";
+
+  for (auto &p : studioCommon.pluginsToLoad)
+    pluginManager.loadPlugin(p);
+
+  if (!parseCommandLine())
+    return;
+
+  for (auto &scene : scenes)
+    for (auto &renderer : renderers)
+      results.push_back(runCase(scene, renderer));
+
+  // Don't hold on to the last scene while writing results
+  resetScene();
+
+  if (!optBaseline.empty())
+    compareBaseline();
+
+  saveResults();
+}
+
+bool BenchmarkContext::parseCommandLine()
+{
+  int argc = studioCommon.argc;
+  const char **argv = studioCommon.argv;
+  int argIndex = 1;
+
+  auto argAvailability = [&](std::string switchArg, int nComp) {
+    if (argc >= argIndex + nComp)
+      return true;
+    std::cout << "Missing argument value for : " << switchArg << std::endl;
+    return false;
+  };
+
+  while (argIndex < argc) {
+    std::string switchArg(argv[argIndex++]);
+
+    if (switchArg == "--help") {
+      printHelp();
+      return false;
+    } else if (switchArg == "--scene") {
+      if (argAvailability(switchArg, 1)) {
+        std::string scene = argv[argIndex++];
+        scenes.push_back(isGenerator(scene) ? scene : "generator_" + scene);
+      }
+    } else if (switchArg == "-r" || switchArg == "--renderer") {
+      if (argAvailability(switchArg, 1))
+        renderers.push_back(argv[argIndex++]);
+    } else if (switchArg == "-s" || switchArg == "--size") {
+      if (argAvailability(switchArg, 2)) {
+        auto x = max(1, atoi(argv[argIndex++]));
+        auto y = max(1, atoi(argv[argIndex++]));
+        optImageSize = vec2i(x, y);
+      }
+    } else if (switchArg == "-spp" || switchArg == "--samples") {
+      if (argAvailability(switchArg, 1))
+        optSPP = max(1, atoi(argv[argIndex++]));
+    } else if (switchArg == "--frames") {
+      if (argAvailability(switchArg, 1))
+        optFrames = max(1, atoi(argv[argIndex++]));
+    } else if (switchArg == "--warmup") {
+      if (argAvailability(switchArg, 1))
+        optWarmupFrames = max(0, atoi(argv[argIndex++]));
+    } else if (switchArg == "--results") {
+      if (argAvailability(switchArg, 1))
+        optResults = argv[argIndex++];
+    } else if (switchArg == "--references") {
+      if (argAvailability(switchArg, 1))
+        optReferenceDir = argv[argIndex++];
+    } else if (switchArg == "--updateReferences") {
+      optUpdateReferences = true;
+    } else if (switchArg == "--tolerance") {
+      if (argAvailability(switchArg, 1))
+        optTolerance = max(0.0, atof(argv[argIndex++]));
+    } else if (switchArg == "--baseline") {
+      if (argAvailability(switchArg, 1))
+        optBaseline = argv[argIndex++];
+    } else if (switchArg == "--maxSlowdown") {
+      if (argAvailability(switchArg, 1))
+        optMaxSlowdown = max(1.0, atof(argv[argIndex++]));
+    } else if (switchArg.front() == '-') {
+      std::cout << " Unknown option: " << switchArg << std::endl;
+      printHelp();
+      return false;
+    } else {
+      scenes.push_back(switchArg);
+    }
+  }
+
+  if (scenes.empty())
+    scenes = defaultScenes;
+  if (renderers.empty())
+    renderers = defaultRenderers;
+
+  if (optUpdateReferences && optReferenceDir.empty()) {
+    std::cout << "--updateReferences needs --references" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+void BenchmarkContext::resetScene()
+{
+  frame = sg::createNodeAs<sg::Frame>("main_frame", "frame");
+  frame->child("scaleNav").setValue(1.f);
+  baseMaterialRegistry = sg::createNodeAs<sg::MaterialRegistry>(
+      "baseMaterialRegistry", "materialRegistry");
+  lightsManager = sg::createNodeAs<sg::LightsManager>("lights", "lights");
+
+  importedModels = nullptr;
+  cameras.clear();
+  cameraStack.clear();
+  sgScene = false;
+  sg::clearAssets();
+}
+
+void BenchmarkContext::loadScene(const std::string &scene)
+{
+  auto world = frame->childNodeAs<sg::Node>("world");
+  world->createChild(
+      "materialref", "reference_to_material", defaultMaterialIdx);
+
+  if (isGenerator(scene)) {
+    auto &gen = world->createChildAs<sg::Generator>("generator", scene);
+    gen.setMaterialRegistry(baseMaterialRegistry);
+    gen.generateData();
+  } else {
+    filesToImport = {scene};
+    importFiles(world);
+  }
+}
+
+BenchmarkContext::CaseResult BenchmarkContext::runCase(
+    const std::string &scene, const std::string &renderer)
+{
+  CaseResult result;
+  result.scene = sceneLabel(scene);
+  result.renderer = renderer;
+
+  std::cout << "benchmarking " << result.scene << " with " << renderer
+            << std::endl;
+
+  resetScene();
+  optRendererTypeStr = renderer;
+
+  const auto start = Clock::now();
+  loadScene(scene);
+  result.loadMs = msSince(start);
+
+  // Everything up to the first renderFrame, as refreshScene() and render()
+  // do it in batch mode
+  const auto commitStart = Clock::now();
+  frame->child("world").render();
+  setupFrame();
+  frame->commit();
+  result.commitMs = msSince(commitStart);
+
+  frame->immediatelyWait = true;
+  frame->startNewFrame();
+  result.firstFrameMs = msSince(start);
+
+  for (int i = 0; i < optWarmupFrames; i++)
+    frame->startNewFrame();
+
+  std::vector<double> frameMs;
+  for (int i = 0; i < optFrames; i++) {
+    const auto frameStart = Clock::now();
+    frame->startNewFrame();
+    frameMs.push_back(msSince(frameStart));
+  }
+  std::sort(frameMs.begin(), frameMs.end());
+  result.msPerFrame = frameMs[frameMs.size() / 2];
+
+  result.peakRssMB = peakRssMB();
+
+  sg::MemoryUsage usage;
+  frame->traverse(usage);
+  baseMaterialRegistry->traverse(usage);
+  result.sceneBytes = usage.totalBytes;
+
+  checkImage(result);
+
+  std::cout << std::fixed << std::setprecision(2)
+            << "  load " << result.loadMs << " ms, commit " << result.commitMs
+            << " ms, first frame " << result.firstFrameMs << " ms, "
+            << result.msPerFrame << " ms/frame, peak RSS " << result.peakRssMB
+            << " MB, scene " << sg::formatBytes(result.sceneBytes)
+            << ", image " << result.image << std::endl;
+  std::cout.unsetf(std::ios::floatfield);
+
+  return result;
+}
+
+void BenchmarkContext::checkImage(CaseResult &result)
+{
+  if (optReferenceDir.empty())
+    return;
+
+  auto &fb = frame->childAs<sg::FrameBuffer>("framebuffer");
+  if (fb.isFloatFormat()) {
+    std::cout << "Only 8 bit framebuffers can be compared" << std::endl;
+    return;
+  }
+
+  const std::string fileName =
+      optReferenceDir + "/" + result.scene + "_" + result.renderer + ".ppm";
+  const vec2i size = fb["size"].valueAs<vec2i>();
+  auto *pixels = (const uint32_t *)frame->mapFrame();
+
+  vec2i refSize;
+  std::vector<uint8_t> ref;
+
+  if (optUpdateReferences) {
+    rkcommon::utility::writePPM(fileName, size.x, size.y, pixels);
+    result.image = "updated";
+  } else if (!readPPM(fileName, refSize, ref)) {
+    std::cout << "No reference image " << fileName << std::endl;
+    result.image = "missing";
+  } else if (refSize != size) {
+    result.image = "fail";
+    result.imageRmse = 1.0;
+  } else {
+    // RGB root mean square error in [0, 1], the framebuffer rows start at
+    // the bottom
+    double sum = 0.0;
+    for (int y = 0; y < size.y; y++) {
+      auto *src = (const uint8_t *)&pixels[size_t(size.y - 1 - y) * size.x];
+      auto *dst = &ref[size_t(y) * size.x * 3];
+      for (int x = 0; x < size.x; x++) {
+        for (int c = 0; c < 3; c++) {
+          const double d = (src[4 * x + c] - dst[3 * x + c]) / 255.0;
+          sum += d * d;
+        }
+      }
+    }
+    result.imageRmse = std::sqrt(sum / (3.0 * size.x * size.y));
+    result.image = result.imageRmse <= optTolerance ? "pass" : "fail";
+  }
+
+  frame->unmapFrame((void *)pixels);
+}
+
+void BenchmarkContext::compareBaseline()
+{
+  std::ifstream in(optBaseline);
+  if (!in) {
+    std::cout << "Could not open baseline " << optBaseline << std::endl;
+    return;
+  }
+
+  JSON baseline;
+  try {
+    in >> baseline;
+  } catch (const std::exception &e) {
+    std::cout << "Could not parse baseline " << optBaseline << ": "
+              << e.what() << std::endl;
+    return;
+  }
+
+  for (auto &result : results) {
+    for (auto &b : baseline["results"]) {
+      if (b["scene"].get<std::string>() != result.scene
+          || b["renderer"].get<std::string>() != result.renderer)
+        continue;
+      const double baseMs = b["msPerFrame"].get<double>();
+      if (baseMs > 0.0) {
+        result.slowdown = result.msPerFrame / baseMs;
+        result.regression = result.slowdown > optMaxSlowdown;
+      }
+      break;
+    }
+  }
+}
+
+void BenchmarkContext::saveResults()
+{
+  int regressions = 0;
+  int imageFailures = 0;
+
+  JSON jResults = JSON::array();
+  for (auto &r : results) {
+    regressions += r.regression;
+    imageFailures += r.image == "fail" || r.image == "missing";
+
+    jResults.push_back({{"scene", r.scene},
+        {"renderer", r.renderer},
+        {"loadMs", r.loadMs},
+        {"commitMs", r.commitMs},
+        {"firstFrameMs", r.firstFrameMs},
+        {"msPerFrame", r.msPerFrame},
+        {"peakRssMB", r.peakRssMB},
+        {"sceneBytes", r.sceneBytes},
+        {"image", r.image},
+        {"imageRmse", r.imageRmse},
+        {"slowdown", r.slowdown},
+        {"regression", r.regression}});
+  }
+
+  JSON j = {{"version", OSPRAY_STUDIO_VERSION},
+      {"size", {optImageSize.x, optImageSize.y}},
+      {"spp", optSPP},
+      {"warmupFrames", optWarmupFrames},
+      {"frames", optFrames},
+      {"tolerance", optTolerance},
+      {"maxSlowdown", optMaxSlowdown},
+      {"regressions", regressions},
+      {"imageFailures", imageFailures},
+      {"results", jResults}};
+
+  std::ofstream json(optResults + ".json");
+  json << j.dump(2) << std::endl;
+
+  std::ofstream csv(optResults + ".csv");
+  csv << "scene,renderer,loadMs,commitMs,firstFrameMs,msPerFrame,peakRssMB,"
+         "sceneBytes,image,imageRmse,slowdown,regression\n";
+  for (auto &r : results) {
+    csv << r.scene << "," << r.renderer << "," << r.loadMs << ","
+        << r.commitMs << "," << r.firstFrameMs << "," << r.msPerFrame << ","
+        << r.peakRssMB << "," << r.sceneBytes << "," << r.image << ","
+        << r.imageRmse << "," << r.slowdown << "," << r.regression << "\n";
+  }
+
+  if (json && csv)
+    std::cout << "Saved results to " << optResults << ".json and "
+              << optResults << ".csv" << std::endl;
+  else
+    std::cerr << "Could not write results to " << optResults << std::endl;
+
+  std::cout << regressions << " performance regressions, " << imageFailures
+            << " image mismatches" << std::endl;
+}
+
+void BenchmarkContext::printHelp()
+{
+  std::cout <<
+      R"text(
+./ospStudio benchmark [parameters] [scene_files]
+
+Renders each scene with each renderer, headless, and saves load, commit,
+first frame and steady-state frame times and the peak memory use.  Without
+--scene or scene files all built-in generators are used.  The peak memory is
+the process high water mark, run one scene per process to isolate it.
+
+ospStudio benchmark specific parameters:
+   --scene [name]
+          built-in generator, e.g. tutorial_scene, wavelet, can be repeated
+   -r     --renderer [type] (default scivis, pathtracer and ao)
+            can be repeated
+   -s     --size [x y] (default 1024x768)
+   -spp   --samples [int] (default 1)
+            samples per pixel of each frame
+   --warmup [int] (default 2)
+          untimed frames after the first frame
+   --frames [int] (default 20)
+          timed frames, the median is reported
+   --results [baseFilename] (default 'ospBenchmark')
+          results are saved to baseFilename.json and baseFilename.csv
+   --references [dir]
+          compare the final images with dir/<scene>_<renderer>.ppm,
+          references depend on the size, spp and frame counts
+   --updateReferences
+          save the final images as the new references
+   --tolerance [float] (default 0.02)
+          largest RGB root mean square error, in [0, 1], of a matching image
+   --baseline [results.json]
+          flag cases whose ms/frame grew by more than --maxSlowdown
+   --maxSlowdown [float] (default 1.1))text"
+            << std::endl;
+}
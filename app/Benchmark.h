@@ -0,0 +1,63 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "Batch.h"
+
+// Renders every scene with every renderer and records load, commit, first
+// frame and steady-state frame times, the peak memory use and how far the
+// image is from a stored reference.  Reuses the batch mode frame setup, so
+// no display is needed.
+
+class BenchmarkContext : public BatchContext
+{
+ public:
+  BenchmarkContext(StudioCommon &studioCommon);
+  ~BenchmarkContext() {}
+
+  void start() override;
+  bool parseCommandLine() override;
+
+ protected:
+  struct CaseResult
+  {
+    std::string scene;
+    std::string renderer;
+    double loadMs{0.0};
+    double commitMs{0.0};
+    double firstFrameMs{0.0}; // from the start of the load
+    double msPerFrame{0.0}; // median of the steady-state frames
+    double peakRssMB{0.0}; // process high water mark after this case
+    size_t sceneBytes{0}; // held by the scene graph, see sg::MemoryUsage
+    // Image check, "pass", "fail", "missing", "updated" or "none"
+    std::string image{"none"};
+    double imageRmse{0.0};
+    // ms/frame relative to the baseline results, 0 if not in the baseline
+    double slowdown{0.0};
+    bool regression{false};
+  };
+
+  void resetScene();
+  void loadScene(const std::string &scene);
+  CaseResult runCase(const std::string &scene, const std::string &renderer);
+  void checkImage(CaseResult &result);
+  void compareBaseline();
+  void saveResults();
+
+  void printHelp() override;
+
+  std::vector<std::string> scenes;
+  std::vector<std::string> renderers;
+
+  int optWarmupFrames{2};
+  int optFrames{20};
+  std::string optResults{"ospBenchmark"};
+  std::string optReferenceDir;
+  bool optUpdateReferences{false};
+  float optTolerance{0.02f};
+  std::string optBaseline;
+  float optMaxSlowdown{1.1f};
+
+  std::vector<CaseResult> results;
+};
@@ -8,9 +8,11 @@
 #include "imgui_impl_opengl2.h"
 // std
 #include <chrono>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 // ospray_sg
+#include "sg/Profiler.h"
 #include "sg/camera/Camera.h"
 #include "sg/exporter/Exporter.h"
 #include "sg/fb/FrameBuffer.h"
@@ -20,6 +22,7 @@
 #include "sg/scene/lights/LightsManager.h"
 #include "sg/visitors/Commit.h"
 #include "sg/visitors/GenerateImGuiWidgets.h"
+#include "sg/visitors/MemoryUsage.h"
 #include "sg/visitors/PrintNodes.h"
 #include "sg/visitors/Search.h"
 #include "sg/visitors/SetParamByNode.h"
@@ -30,6 +33,7 @@
 #include "rkcommon/utility/SaveImage.h"
 #include "rkcommon/utility/getEnvVar.h"
 #include "rkcommon/utility/DataView.h"
+#include "rkcommon/tasking/parallel_for.h"
 
 // json
 #include "sg/JSONDefs.h"
@@ -53,7 +57,8 @@ static const std::vector<std::string> g_scenes = {"tutorial_scene",
     "wavelet",
     "torus_volume",
     "unstructured_volume",
-    "multilevel_hierarchy"};
+    "multilevel_hierarchy",
+    "stress_scene"};
 
 static const std::vector<std::string> g_renderers = {
     "scivis", "pathtracer", "ao", "debug"};
@@ -94,6 +99,66 @@ double g_camMoveR = 0.0;
 
 float lockAspectRatio = 0.0;
 
+// Pixel buffer object entry points, GL 1.5 but often missing from the GL 1.1
+// headers, so they're looked up at runtime.  Null if not supported.
+#ifdef _WIN32
+#define STUDIO_GL_APIENTRY __stdcall
+#else
+#define STUDIO_GL_APIENTRY
+#endif
+
+static void(STUDIO_GL_APIENTRY *g_glGenBuffers)(GLsizei, GLuint *) = nullptr;
+static void(STUDIO_GL_APIENTRY *g_glDeleteBuffers)(
+    GLsizei, const GLuint *) = nullptr;
+static void(STUDIO_GL_APIENTRY *g_glBindBuffer)(GLenum, GLuint) = nullptr;
+static void(STUDIO_GL_APIENTRY *g_glBufferData)(
+    GLenum, std::ptrdiff_t, const void *, GLenum) = nullptr;
+static void *(STUDIO_GL_APIENTRY *g_glMapBuffer)(GLenum, GLenum) = nullptr;
+static GLboolean(STUDIO_GL_APIENTRY *g_glUnmapBuffer)(GLenum) = nullptr;
+
+template <typename FCN_T>
+static bool loadGLFunction(FCN_T &fcn, const char *name)
+{
+  fcn = reinterpret_cast<FCN_T>(glfwGetProcAddress(name));
+  return fcn != nullptr;
+}
+
+// Frames are copied and converted in parallel, in blocks of this many pixels
+// (bytes for plain copies)
+static const size_t g_uploadBlockSize = 1 << 16;
+
+// Scale depth to [0, 1], or [1, 0] if inverted, ignoring infinite values
+static void normalizeDepth(
+    const float *depth, float *out, size_t numPixels, bool invert)
+{
+  const size_t numBlocks =
+      (numPixels + g_uploadBlockSize - 1) / g_uploadBlockSize;
+
+  const range1f emptyRange(rkcommon::math::inf, rkcommon::math::neg_inf);
+  std::vector<range1f> blockRanges(numBlocks, emptyRange);
+  rkcommon::tasking::parallel_for(numBlocks, [&](size_t b) {
+    const size_t end = std::min(numPixels, (b + 1) * g_uploadBlockSize);
+    for (size_t i = b * g_uploadBlockSize; i < end; i++) {
+      if (!std::isinf(depth[i]))
+        blockRanges[b].extend(depth[i]);
+    }
+  });
+
+  range1f depthRange = emptyRange;
+  for (auto &r : blockRanges)
+    depthRange.extend(r);
+
+  const float rcpDepthRange = 1.f / depthRange.size();
+  const float scale = invert ? -rcpDepthRange : rcpDepthRange;
+  const float offset = (invert ? 1.f : 0.f) - depthRange.lower * scale;
+
+  rkcommon::tasking::parallel_for(numBlocks, [&](size_t b) {
+    const size_t end = std::min(numPixels, (b + 1) * g_uploadBlockSize);
+    for (size_t i = b * g_uploadBlockSize; i < end; i++)
+      out[i] = depth[i] * scale + offset;
+  });
+}
+
 std::string quatToString(quaternionf &q)
 {
   std::stringstream ss;
@@ -367,6 +432,8 @@ MainWindow::MainWindow(StudioCommon &_common)
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
+  initPixelBuffers();
+
   refreshRenderer();
   refreshScene(true);
 
@@ -377,6 +444,8 @@ MainWindow::MainWindow(StudioCommon &_common)
 
 MainWindow::~MainWindow()
 {
+  if (!pixelBuffers.empty())
+    g_glDeleteBuffers(pixelBuffers.size(), pixelBuffers.data());
   ImGui_ImplOpenGL2_Shutdown();
   ImGui_ImplGlfw_Shutdown();
   ImGui::DestroyContext();
@@ -690,53 +759,7 @@ void MainWindow::display()
       const GLenum glType =
           frameBuffer.isFloatFormat() ? GL_FLOAT : GL_UNSIGNED_BYTE;
 
-      // Only create the copy if it's needed
-      float *pDepthCopy = nullptr;
-      if (showDepth) {
-        // Create a local copy and don't modify OSPRay buffer
-        const auto *mappedDepth = static_cast<const float *>(mappedFB);
-        std::vector<float> depthCopy(
-            mappedDepth, mappedDepth + fbSize.x * fbSize.y);
-        pDepthCopy = depthCopy.data();
-
-        // Scale OSPRay's 0 -> inf depth range to OpenGL 0 -> 1, ignoring all
-        // inf values
-        float minDepth = rkcommon::math::inf;
-        float maxDepth = rkcommon::math::neg_inf;
-        for (auto depth : depthCopy) {
-          if (isinf(depth))
-            continue;
-          minDepth = std::min(minDepth, depth);
-          maxDepth = std::max(maxDepth, depth);
-        }
-
-        const float rcpDepthRange = 1.f / (maxDepth - minDepth);
-
-        // Inverted depth (1.0 -> 0.0) may be more meaningful
-        if (showDepthInvert)
-          std::transform(depthCopy.begin(),
-              depthCopy.end(),
-              depthCopy.begin(),
-              [&](float depth) {
-                return (1.f - (depth - minDepth) * rcpDepthRange);
-              });
-        else
-          std::transform(depthCopy.begin(),
-              depthCopy.end(),
-              depthCopy.begin(),
-              [&](float depth) { return (depth - minDepth) * rcpDepthRange; });
-      }
-
-      glBindTexture(GL_TEXTURE_2D, framebufferTexture);
-      glTexImage2D(GL_TEXTURE_2D,
-          0,
-          showAlbedo ? gl_rgb_format : gl_rgba_format,
-          fbSize.x,
-          fbSize.y,
-          0,
-          showDepth ? GL_LUMINANCE : (showAlbedo ? GL_RGB : GL_RGBA),
-          glType,
-          showDepth ? pDepthCopy : mappedFB);
+      uploadFrame(mappedFB, glType);
 
       frame->unmapFrame(mappedFB);
 
@@ -815,14 +838,29 @@ void MainWindow::display()
 
 void MainWindow::startNewOSPRayFrame()
 {
+  // Deferred models are imported one a frame, those which may be visible
+  // first.  Only the stand-ins are lazy, the import itself still runs here
+  // and stalls the UI for as long as the model takes to load.
+  if (!sg::deferredImports.empty()) {
+    try {
+      sg::importNextDeferred(frame->child("camera"), importAllDeferred);
+    } catch (...) {
+      std::cerr << "Failed to import a deferred model!\n";
+    }
+    if (sg::deferredImports.empty())
+      importAllDeferred = false;
+  }
+
   // The baseMaterialRegistry and lightsManager don't hang off the frame, so
   // must be checked separately.  If modified, notify the frame by modifying a
   // child.
   if (baseMaterialRegistry->isModified()) {
-    baseMaterialRegistry->commit();
-    baseMaterialRegistry->updateMaterialList(rendererTypeStr);
-    auto &r = frame->childAs<sg::Renderer>("renderer");
-    r.createChildData("material", baseMaterialRegistry->cppMaterialList);
+    // Material edits are committed in place, the renderer only needs a new
+    // material array when materials were added or removed
+    if (baseMaterialRegistry->updateMaterialList(rendererTypeStr)) {
+      auto &r = frame->childAs<sg::Renderer>("renderer");
+      r.createChildData("material", baseMaterialRegistry->cppMaterialList);
+    }
     frame->child("navMode") = true; // navMode is perfect for this
   }
 
@@ -852,6 +890,118 @@ void MainWindow::waitOnOSPRayFrame()
   frame->waitOnFrame();
 }
 
+void MainWindow::initPixelBuffers()
+{
+  const bool supported = loadGLFunction(g_glGenBuffers, "glGenBuffers")
+      && loadGLFunction(g_glDeleteBuffers, "glDeleteBuffers")
+      && loadGLFunction(g_glBindBuffer, "glBindBuffer")
+      && loadGLFunction(g_glBufferData, "glBufferData")
+      && loadGLFunction(g_glMapBuffer, "glMapBuffer")
+      && loadGLFunction(g_glUnmapBuffer, "glUnmapBuffer");
+
+  if (!supported) {
+    std::cerr << "Pixel buffer objects not supported, "
+              << "uploading frames directly\n";
+    return;
+  }
+
+  // Two buffers, so filling one doesn't wait on the transfer of the other
+  pixelBuffers.resize(2);
+  g_glGenBuffers(pixelBuffers.size(), pixelBuffers.data());
+}
+
+void MainWindow::uploadFrame(const void *mappedFB, GLenum glType)
+{
+  const GLenum internalFormat = showAlbedo ? gl_rgb_format : gl_rgba_format;
+  const GLenum format =
+      showDepth ? GL_LUMINANCE : (showAlbedo ? GL_RGB : GL_RGBA);
+  const size_t numPixels = size_t(fbSize.x) * fbSize.y;
+  const size_t numChannels = showDepth ? 1 : (showAlbedo ? 3 : 4);
+  const size_t numBytes = numPixels * numChannels
+      * (glType == GL_FLOAT ? sizeof(float) : sizeof(uint8_t));
+
+  glBindTexture(GL_TEXTURE_2D, framebufferTexture);
+
+  // Storage is only (re)specified when the size or format changes, every
+  // other frame just replaces the texels
+  if (fbSize != textureSize || internalFormat != textureFormat) {
+    glTexImage2D(GL_TEXTURE_2D,
+        0,
+        internalFormat,
+        fbSize.x,
+        fbSize.y,
+        0,
+        format,
+        glType,
+        nullptr);
+    textureSize = fbSize;
+    textureFormat = internalFormat;
+  }
+
+  // Fills dst with the frame, converting depth for display
+  auto copyFrame = [&](void *dst) {
+    if (showDepth) {
+      normalizeDepth(static_cast<const float *>(mappedFB),
+          static_cast<float *>(dst),
+          numPixels,
+          showDepthInvert);
+    } else {
+      const size_t numBlocks =
+          (numBytes + g_uploadBlockSize - 1) / g_uploadBlockSize;
+      rkcommon::tasking::parallel_for(numBlocks, [&](size_t b) {
+        const size_t begin = b * g_uploadBlockSize;
+        std::memcpy(static_cast<char *>(dst) + begin,
+            static_cast<const char *>(mappedFB) + begin,
+            std::min(g_uploadBlockSize, numBytes - begin));
+      });
+    }
+  };
+
+  if (!pixelBuffers.empty()) {
+    g_glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[pixelBufferIndex]);
+    pixelBufferIndex = (pixelBufferIndex + 1) % pixelBuffers.size();
+
+    // Orphan the old storage instead of waiting for GL to finish reading it
+    g_glBufferData(GL_PIXEL_UNPACK_BUFFER, numBytes, nullptr, GL_STREAM_DRAW);
+    void *dst = g_glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+    if (dst) {
+      copyFrame(dst);
+      g_glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+      // The transfer from the buffer then overlaps with the next render
+      glTexSubImage2D(GL_TEXTURE_2D,
+          0,
+          0,
+          0,
+          fbSize.x,
+          fbSize.y,
+          format,
+          glType,
+          nullptr);
+      g_glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+      return;
+    }
+    g_glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  }
+
+  // Without pixel buffers upload from the mapped frame, depth needs a copy
+  const void *pixels = mappedFB;
+  if (showDepth) {
+    depthCopy.resize(numPixels);
+    copyFrame(depthCopy.data());
+    pixels = depthCopy.data();
+  }
+
+  glTexSubImage2D(GL_TEXTURE_2D,
+      0,
+      0,
+      0,
+      fbSize.x,
+      fbSize.y,
+      format,
+      glType,
+      pixels);
+}
+
 void MainWindow::updateTitleBar()
 {
   std::stringstream windowTitle;
@@ -910,22 +1060,40 @@ void MainWindow::buildUI()
 
 void MainWindow::refreshRenderer()
 {
-  auto &r = frame->createChildAs<sg::Renderer>(
-      "renderer", "renderer_" + rendererTypeStr);
+  // Renderers are kept by type, with their parameters, material array and
+  // committed handles, so switching back to one doesn't recreate anything
+  if (frame->hasChild("renderer")) {
+    auto &current = frame->child("renderer");
+    renderers[current.subType()] = current.shared_from_this();
+  }
+
+  auto cached = renderers.find("renderer_" + rendererTypeStr);
+  // A removed backplate can't be unset on a renderer, start over instead
+  bool reuse = cached != renderers.end()
+      && (backPlateTexture != "" || !cached->second->hasChild("map_backplate"));
+
+  if (reuse)
+    frame->add(cached->second, "renderer");
+  auto &r = reuse ? frame->childAs<sg::Renderer>("renderer")
+                  : frame->createChildAs<sg::Renderer>(
+                      "renderer", "renderer_" + rendererTypeStr);
 
-  if (optPF >= 0)
+  if (!reuse && optPF >= 0)
     r.createChild("pixelFilter", "int", optPF);
 
   if (rendererTypeStr != "debug") {
-    baseMaterialRegistry->updateMaterialList(rendererTypeStr);
-    r.createChildData("material", baseMaterialRegistry->cppMaterialList);
+    if (baseMaterialRegistry->updateMaterialList(rendererTypeStr) || !reuse)
+      r.createChildData("material", baseMaterialRegistry->cppMaterialList);
   }
   if (rendererTypeStr == "scivis" || rendererTypeStr == "pathtracer") {
     if (backPlateTexture != "") {
-      auto backplateTex =
-          sg::createNodeAs<sg::Texture2D>("map_backplate", "texture_2d");
-      backplateTex->load(backPlateTexture, false, false);
-      r.add(backplateTex);
+      // One texture is loaded and shared by all renderers
+      if (!backPlateTex || backPlateTex->fileName != backPlateTexture.str()) {
+        backPlateTex =
+            sg::createNodeAs<sg::Texture2D>("map_backplate", "texture_2d");
+        backPlateTex->load(backPlateTexture, false, false);
+      }
+      r.add(backPlateTex);
     }
   }
 }
@@ -995,6 +1163,16 @@ bool MainWindow::parseCommandLine()
       --i;
     } else if (arg == "--animate" || arg == "-a") {
       animate = true;
+    } else if (arg == "--dedupMaterials") {
+      baseMaterialRegistry->deduplicate = true;
+    } else if (arg == "--deferImports") {
+      optDeferImports = true;
+    } else if (arg == "--lod") {
+      optLodGridSize = max(0, atoi(av[i + 1]));
+      rkcommon::removeArgs(ac, av, i, 2);
+      --i;
+      if (frame->lodNavPixels == 0.f)
+        frame->lodNavPixels = 64.f;
     } else if (arg == "--dimensions" || arg == "-d") {
       const std::string dimX(av[++i]);
       const std::string dimY(av[++i]);
@@ -1063,6 +1241,7 @@ void MainWindow::importFiles(sg::NodePtr world)
         sgScene = true;
       } else {
         std::cout << "Importing: " << file << std::endl;
+        SG_PROFILE_SCOPE("importScene", file);
 
         auto importer = sg::getImporter(world, file);
         if (importer) {
@@ -1072,8 +1251,20 @@ void MainWindow::importFiles(sg::NodePtr world)
             importer->setVolumeParams(&vp);
 
           importer->setMaterialRegistry(baseMaterialRegistry);
-          importer->setCameraList(cameras);
           importer->setLightsManager(lightsManager);
+          importer->setLodGridSize(optLodGridSize);
+          importer->setDeferReferences(optDeferImports && !sceneMaterials);
+
+          // Only models whose bounds a scene file declares are deferred, the
+          // others are needed to place the camera.  Cameras and animations
+          // only come with models imported now.
+          auto bounds = importBounds.find(file);
+          if (optDeferImports && bounds != importBounds.end()) {
+            importer->deferImport(bounds->second);
+            continue;
+          }
+
+          importer->setCameraList(cameras);
           if (animationManager)
             importer->setAnimationList(animationManager->getAnimations());
           importer->importScene();
@@ -1183,6 +1374,11 @@ void MainWindow::buildMainMenuFile()
       showImportFileBrowser = true;
       animate = true;
     }
+    if (ImGui::MenuItem("Import deferred models",
+            nullptr,
+            false,
+            !sg::deferredImports.empty()))
+      importAllDeferred = true;
     if (ImGui::BeginMenu("Demo Scene")) {
       for (size_t i = 0; i < g_scenes.size(); ++i) {
         if (ImGui::MenuItem(g_scenes[i].c_str(), nullptr)) {
@@ -1202,16 +1398,25 @@ void MainWindow::buildMainMenuFile()
 
       // TODO: lights caching to avoid complete re-importing after clearing
       sg::clearAssets();
+      importAllDeferred = false;
 
       // Recreate MaterialRegistry, clearing old registry and all materials
+      const bool deduplicate = baseMaterialRegistry->deduplicate;
       baseMaterialRegistry = sg::createNodeAs<sg::MaterialRegistry>(
           "baseMaterialRegistry", "materialRegistry");
+      baseMaterialRegistry->deduplicate = deduplicate;
 
       scene = "";
       refreshScene(true);
     }
     if (ImGui::BeginMenu("Save...")) {
       if (ImGui::MenuItem("Scene (entire)")) {
+        // Saved model bounds let the scene be imported with --deferImports
+        for (auto &c : frame->child("world").children()) {
+          if (c.second->type() == sg::NodeType::IMPORTER)
+            c.second->nodeAs<sg::Importer>()->updateModelBounds();
+        }
+
         std::ofstream dump("studio_scene.sg");
         JSON j = {{"world", frame->child("world")},
             {"camera", arcballCamera->getState()},
@@ -1317,10 +1522,6 @@ void MainWindow::buildMainMenuEdit()
             g_renderers.size())) {
       rendererTypeStr = g_renderers[whichRenderer];
 
-      if (rendererType == OSPRayRendererType::DEBUGGER)
-        whichDebuggerType = 0; // reset UI if switching away
-                               // from debug renderer
-
       if (rendererTypeStr == "scivis")
         rendererType = OSPRayRendererType::SCIVIS;
       else if (rendererTypeStr == "pathtracer")
@@ -1546,11 +1747,7 @@ void MainWindow::buildMainMenuEdit()
 
         if (!fileList.empty()) {
           backPlateTexture = fileList[0];
-
-          auto backplateTex =
-              sg::createNodeAs<sg::Texture2D>("map_backplate", "texture_2d");
-          backplateTex->load(backPlateTexture, false, false);
-          frame->child("renderer").add(backplateTex);
+          refreshRenderer();
         }
       }
     }
@@ -1608,6 +1805,21 @@ void MainWindow::buildMainMenuView()
     ImGui::DragInt(
         "Limit accumulation", &frame->accumLimit, 1, 0, INT_MAX, "%d frames");
 
+    ImGui::Checkbox("Cull while navigating", &frame->cullNav);
+    if (frame->cullNav) {
+      ImGui::SameLine();
+      ImGui::SetNextItemWidth(5 * ImGui::GetFontSize());
+      ImGui::DragFloat(
+          "min size", &frame->cullNavPixels, 0.1f, 0.f, 100.f, "%.1f pixels");
+    }
+    ImGui::SetNextItemWidth(5 * ImGui::GetFontSize());
+    ImGui::DragFloat("Simplify while navigating below",
+        &frame->lodNavPixels,
+        1.f,
+        0.f,
+        4096.f,
+        "%.0f pixels");
+
     ImGui::Checkbox("auto rotate", &autorotate);
     if (autorotate) {
       ImGui::SameLine();
@@ -2028,7 +2240,28 @@ void MainWindow::buildWindowMaterialEditor()
     return;
   }
 
-  baseMaterialRegistry->traverse<sg::GenerateImGuiWidgets>();
+  // Registries may hold tens of thousands of materials, only generate the
+  // rows in view and only collect the materials when the registry changes
+  static sg::TreeView materialView;
+  static std::vector<sg::Node *> materials;
+  static sg::MaterialRegistry *materialsRegistry = nullptr;
+  static sg::TimeStamp materialsCollected;
+  if (materialsRegistry != baseMaterialRegistry.get()
+      || baseMaterialRegistry->structureLastModified() > materialsCollected) {
+    materials.clear();
+    materials.reserve(baseMaterialRegistry->children().size());
+    for (auto &mat : baseMaterialRegistry->children())
+      materials.push_back(mat.second.get());
+    materialsRegistry = baseMaterialRegistry.get();
+    materialsCollected.renew();
+  }
+
+  ImGui::BeginChild(
+      "materials", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+  auto *updatedMaterial = materialView.draw(materials);
+  if (updatedMaterial)
+    updatedMaterial->commit();
+  ImGui::EndChild();
 
   ImGui::End();
 }
@@ -2257,23 +2490,35 @@ void MainWindow::buildWindowTransformEditor()
   static char searchTerm[1024] = "";
   static bool searched = false;
   static std::vector<sg::Node *> results;
+  static std::string resultsTerm;
+  static sg::TimeStamp resultsTime;
 
   auto doClear = [&]() {
     searched = false;
     results.clear();
+    resultsTerm.clear();
     searchTerm[0] = '\0';
   };
+  auto runSearch = [&](const std::string &term) {
+    results.clear();
+    frame->traverse<sg::Search>(term, sg::NodeType::GEOMETRY, results);
+    resultsTerm = term;
+    resultsTime.renew();
+  };
   auto doSearch = [&]() {
     if (std::string(searchTerm).size() > 0) {
       searched = true;
-      results.clear();
-      frame->traverse<sg::Search>(
-          std::string(searchTerm), sg::NodeType::GEOMETRY, results);
+      if (resultsTerm != searchTerm)
+        runSearch(searchTerm);
     } else {
       doClear();
     }
   };
 
+  // Results stay valid until nodes are added or removed
+  if (searched && frame->structureLastModified() > resultsTime)
+    runSearch(resultsTerm);
+
   if (ImGui::InputTextWithHint("##findTransformEditor",
           "search...",
           searchTerm,
@@ -2291,26 +2536,26 @@ void MainWindow::buildWindowTransformEditor()
     doClear();
   }
 
-  if (ImGui::Button("show all")) {
+  // Geometries are looked up in an index of the world, which only revisits
+  // the parts of the world which changed since the last use
+  static sg::NodeIndex worldIndex;
+  auto setAllVisible = [&](bool visible) {
     if (searched) {
       for (auto result : results)
-        result->child("visible").setValue(true);
+        result->child("visible").setValue(visible);
     } else {
-      frame->child("world").traverse<sg::SetParamByNode>(
-          sg::NodeType::GEOMETRY, "visible", true);
+      worldIndex.update(frame->child("world"));
+      sg::setParamByNode(
+          worldIndex, sg::NodeType::GEOMETRY, "visible", visible);
     }
-  }
+  };
+
+  if (ImGui::Button("show all"))
+    setAllVisible(true);
 
   ImGui::SameLine();
-  if (ImGui::Button("hide all")) {
-    if (searched) {
-      for (auto result : results)
-        result->child("visible").setValue(false);
-    } else {
-      frame->child("world").traverse<sg::SetParamByNode>(
-          sg::NodeType::GEOMETRY, "visible", false);
-    }
-  }
+  if (ImGui::Button("hide all"))
+    setAllVisible(false);
 
   if (searched) {
     ImGui::SameLine();
@@ -2320,32 +2565,23 @@ void MainWindow::buildWindowTransformEditor()
 
   ImGui::BeginChild(
       "geometry", ImVec2(0, 0), true, ImGuiWindowFlags_HorizontalScrollbar);
-  bool userUpdated = false;
+  static sg::TreeView resultsView(sg::TreeState::ALLCLOSED);
+  static sg::TreeView worldView(sg::TreeState::ROOTOPEN);
+  sg::Node *updatedNode = nullptr;
   if (searched) {
-    for (auto result : results) {
-      result->traverse<sg::GenerateImGuiWidgets>(
-          sg::TreeState::ALLCLOSED, userUpdated);
-      // Don't continue traversing
-      if (userUpdated) {
-        result->commit();
-        break;
-      }
-    }
+    updatedNode = resultsView.draw(results);
   } else {
+    std::vector<sg::Node *> roots;
     for (auto &node : frame->child("world").children()) {
       if (node.second->type() == sg::NodeType::GENERATOR
           || node.second->type() == sg::NodeType::IMPORTER
-          || node.second->type() == sg::NodeType::TRANSFORM) {
-        node.second->traverse<sg::GenerateImGuiWidgets>(
-            sg::TreeState::ROOTOPEN, userUpdated);
-        // Don't continue traversing
-        if (userUpdated) {
-          node.second->commit();
-          break;
-        }
-      }
+          || node.second->type() == sg::NodeType::TRANSFORM)
+        roots.push_back(node.second.get());
     }
+    updatedNode = worldView.draw(roots);
   }
+  if (updatedNode)
+    updatedNode->commit();
   ImGui::EndChild();
 
   ImGui::End();
@@ -2386,6 +2622,78 @@ void MainWindow::buildWindowRenderingStats()
     ImGui::ProgressBar(progress, ImVec2(0.f, 0.f), progressStr.c_str());
   }
 
+  if (sg::Profiler::enabled()) {
+    // Summarizing walks all buffered events, refresh twice a second
+    static std::vector<sg::Profiler::Summary> profile;
+    static auto lastUpdate = std::chrono::steady_clock::now();
+    auto now = std::chrono::steady_clock::now();
+    if (profile.empty() || now - lastUpdate > std::chrono::milliseconds(500)) {
+      profile = sg::Profiler::summary();
+      lastUpdate = now;
+    }
+
+    ImGui::Separator();
+    ImGui::Columns(4, "profile", false);
+    for (auto title : {"event", "count", "total ms", "max ms"}) {
+      ImGui::Text("%s", title);
+      ImGui::NextColumn();
+    }
+    const size_t maxRows = 12;
+    for (size_t i = 0; i < std::min(profile.size(), maxRows); i++) {
+      auto &p = profile[i];
+      ImGui::Text("%s", p.name.c_str());
+      ImGui::NextColumn();
+      ImGui::Text("%zu", p.count);
+      ImGui::NextColumn();
+      ImGui::Text("%.2f", p.totalMs);
+      ImGui::NextColumn();
+      ImGui::Text("%.2f", p.maxMs);
+      ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+  }
+
+  if (ImGui::CollapsingHeader("memory")) {
+    // Walks the whole scene, refresh every two seconds.  Only names are kept,
+    // nodes may be gone by the next refresh.
+    static std::string total;
+    static std::vector<std::pair<std::string, std::string>> byType;
+    static std::vector<std::pair<std::string, std::string>> largest;
+    static auto lastUpdate = std::chrono::steady_clock::time_point();
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastUpdate > std::chrono::seconds(2)) {
+      sg::MemoryUsage usage;
+      frame->traverse(usage);
+      baseMaterialRegistry->traverse(usage);
+
+      total = sg::formatBytes(usage.totalBytes);
+      byType.clear();
+      for (auto &t : usage.bytesByType)
+        byType.emplace_back(
+            sg::NodeTypeToString[t.first], sg::formatBytes(t.second));
+      largest.clear();
+      for (auto &u : usage.largest(8)) {
+        if (u.subtreeBytes)
+          largest.emplace_back(
+              u.node->name(), sg::formatBytes(u.subtreeBytes));
+      }
+      lastUpdate = now;
+    }
+
+    ImGui::Text("total: %s", total.c_str());
+    ImGui::Columns(2, "memory", false);
+    for (auto *rows : {&byType, &largest}) {
+      ImGui::Separator();
+      for (auto &row : *rows) {
+        ImGui::Text("%s", row.first.c_str());
+        ImGui::NextColumn();
+        ImGui::Text("%s", row.second.c_str());
+        ImGui::NextColumn();
+      }
+    }
+    ImGui::Columns(1);
+  }
+
   ImGui::End();
 }
 
@@ -2402,6 +2710,19 @@ void MainWindow::printHelp()
                                3 = Mitchell-Netravali
                                4 = Blackman-Harris
     -a, --animate            enable loading glTF animations
+    --dedupMaterials         share one material between imports whose
+                             materials and textures are identical
+    --deferImports           import models once they come into view,
+                             drawing the bounds a scene file declares
+                             until then, or all from the File menu;
+                             models without declared bounds, and all
+                             of a scene file that overrides materials,
+                             are imported right away; a model is still
+                             loaded within one frame, pausing the UI
+    --lod N                  give imported meshes a simplified stand-in,
+                             rendered while navigating for models small on
+                             screen, N is the grid size vertices are merged
+                             on, 0 for bounding boxes
     --2160p, --1440p,        set window/frame resolution
     --1080p, --720p,
     --540p, --270p
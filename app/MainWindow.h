@@ -37,6 +37,15 @@ using rkcommon::make_unique;
 #ifndef GL_RGB32F
 #define GL_RGB32F 0x8815
 #endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_WRITE_ONLY
+#define GL_WRITE_ONLY 0x88B9
+#endif
 
 enum class OSPRayRendererType
 {
@@ -103,6 +112,8 @@ class MainWindow : public StudioContext
   void display();
   void startNewOSPRayFrame();
   void waitOnOSPRayFrame();
+  void initPixelBuffers();
+  void uploadFrame(const void *mappedFB, GLenum glType);
   void buildUI();
   void addLight();
   void removeLight();
@@ -186,14 +197,32 @@ class MainWindow : public StudioContext
 
   OSPRayRendererType rendererType{OSPRayRendererType::SCIVIS};
   int optPF = -1; // optional pixel filter, -1 = use default
+  int optLodGridSize = -1; // stand-ins for imported meshes, -1 = none
+  bool optDeferImports{false}; // import models once they're visible
+  bool importAllDeferred{false}; // import deferred models whether visible
 
   rkcommon::FileName backPlateTexture = "";
+  std::shared_ptr<sg::Texture2D> backPlateTex;
+
+  // Renderers used so far by subtype, see refreshRenderer()
+  std::map<std::string, sg::NodePtr> renderers;
 
   // GLFW window instance
   GLFWwindow *glfwWindow = nullptr;
 
   // OpenGL framebuffer texture
   GLuint framebufferTexture = 0;
+  // Size and internal format its storage was last specified with
+  vec2i textureSize{0};
+  GLenum textureFormat{0};
+
+  // Ring of pixel buffer objects frames are streamed through, empty if not
+  // supported by the GL implementation
+  std::vector<GLuint> pixelBuffers;
+  size_t pixelBufferIndex{0};
+
+  // Normalized depth when uploading without pixel buffers
+  std::vector<float> depthCopy;
 
   // optional registered display callback, called before every display()
   std::function<void(MainWindow *)> displayCallback;
@@ -11,10 +11,9 @@
 // json
 #include "sg/JSONDefs.h"
 
+#include <algorithm>
 #include <chrono>
 
-#include "../sg/scene/volume/VDBVolumeTimeStep.h"
-#include "../sg/scene/volume/VolumeTimeStep.h"
 #include "../sg/scene/volume/Volume.h"
 
 using namespace ospray::sg;
@@ -60,24 +59,210 @@ void TimeSeriesWindow::start()
 
 bool TimeSeriesWindow::isTimestepVolumeLoaded(int variableNum, size_t timestep)
 {
-  bool loaded = true;
+  if (timestep >= allVariablesData[variableNum].size()) {
+    throw std::runtime_error("out of bounds timestep selected");
+  }
 
-  for (size_t v = 0; v < allVariablesData[variableNum].size(); v++) {
-    if (timestep >= allVariablesData[variableNum].size()) {
-      throw std::runtime_error("out of bounds timestep selected");
-    }
-    if (importAsSeparateTimeseries)
-      loaded = g_allSeparateWorlds[variableNum][timestep]->hasChild(
-          "sgVolume_" + to_string(variableNum));
+  auto &world = importAsSeparateTimeseries
+      ? g_allSeparateWorlds[variableNum][timestep]
+      : g_allWorlds[timestep];
 
-    else {
-      if (!g_allWorlds[timestep]->hasChild("sgVolume_" + to_string(variableNum))) {
-      loaded = false;
+  return world || timestepVolumes[variableNum][timestep].ready();
+}
+
+bool TimeSeriesWindow::isTimestepReady(int timestep)
+{
+  if (importAsSeparateTimeseries)
+    return isTimestepVolumeLoaded(whichVariable, timestep);
+
+  for (size_t i = 0; i < allVariablesData.size(); i++)
+    if (!isTimestepVolumeLoaded(i, timestep))
+      return false;
+
+  return true;
+}
+
+void TimeSeriesWindow::TimestepVolume::queue()
+{
+  if (raw)
+    raw->queueGenerateVolumeData();
+  else
+    vdb->queueGenerateVolumeData();
+  queued = true;
+}
+
+bool TimeSeriesWindow::TimestepVolume::ready() const
+{
+  return raw ? raw->isVolumeDataReady() : vdb->isVolumeDataReady();
+}
+
+std::shared_ptr<sg::Volume> TimeSeriesWindow::TimestepVolume::createSGVolume()
+{
+  // waits for the data if it is still being read
+  if (raw)
+    return raw->createSGVolume();
+
+  auto vol = vdb->createSGVolume();
+  vol->child("anisotropy").setValue(0.875f);
+  vol->child("densityScale").setValue(1.f);
+  return vol;
+}
+
+void TimeSeriesWindow::createTimestepVolumes()
+{
+  size_t maxTimesteps = 0;
+
+  for (size_t i = 0; i < allVariablesData.size(); i++) {
+    std::vector<TimestepVolume> volumes(allVariablesData[i].size());
+
+    for (size_t f = 0; f < allVariablesData[i].size(); f++) {
+      auto &file = allVariablesData[i][f];
+
+      if (file.length() > 4 && file.substr(file.length() - 4) == ".vdb") {
+        volumes[f].vdb = std::make_shared<VDBVolumeTimestep>(file);
+        volumes[f].vdb->localLoading = g_localLoading;
+        volumes[f].vdb->variableNum = i;
+      } else {
+        if (dimensions.x == -1 || gridSpacing.x == -1) {
+          throw std::runtime_error(
+              "improper dimensions or grid spacing specified for volume");
+        }
+        if (voxelType == 0)
+          throw std::runtime_error("improper voxelType specified for volume");
+
+        volumes[f].raw = std::make_shared<VolumeTimestep>(
+            file, voxelType, dimensions, gridOrigin, gridSpacing);
+        volumes[f].raw->localLoading = g_localLoading;
+        volumes[f].raw->variableNum = i;
+        volumes[f].raw->quantizeBits = variableQuantizeBits[i];
       }
     }
+
+    maxTimesteps = std::max(maxTimesteps, volumes.size());
+    timestepVolumes.push_back(std::move(volumes));
   }
 
-  return loaded;
+  // read early timesteps first so playback can start while loading
+  for (size_t f = 0; f < maxTimesteps; f++)
+    for (size_t i = 0; i < allVariablesData.size(); i++)
+      if (f < allVariablesData[i].size())
+        loadOrder.emplace_back(i, f);
+}
+
+void TimeSeriesWindow::updateLoaders()
+{
+  if (g_localLoading)
+    return;
+
+  loading.erase(std::remove_if(loading.begin(),
+                    loading.end(),
+                    [](TimestepVolume *v) { return v->ready(); }),
+      loading.end());
+
+  while (nextToLoad < loadOrder.size()
+      && loading.size() < size_t(std::max(maxLoaders, 1))) {
+    auto &next = loadOrder[nextToLoad++];
+    auto &volume = timestepVolumes[next.first][next.second];
+    if (volume.queued)
+      continue;
+
+    volume.queue();
+    loading.push_back(&volume);
+  }
+}
+
+void TimeSeriesWindow::requestTimestep(int timestep)
+{
+  pendingTimestep = timestep;
+
+  // read it ahead of the load order
+  auto queueVolume = [&](int variableNum) {
+    auto &volume = timestepVolumes[variableNum][timestep];
+    if (!g_localLoading && !volume.queued) {
+      volume.queue();
+      loading.push_back(&volume);
+    }
+  };
+
+  if (importAsSeparateTimeseries)
+    queueVolume(whichVariable);
+  else
+    for (size_t i = 0; i < timestepVolumes.size(); i++)
+      queueVolume(i);
+
+  showPendingTimestep();
+}
+
+void TimeSeriesWindow::showPendingTimestep()
+{
+  if (pendingTimestep < 0 || !isTimestepReady(pendingTimestep))
+    return;
+
+  if (importAsSeparateTimeseries)
+    setVariableTimeseries(whichVariable, pendingTimestep);
+  else
+    setTimestep(pendingTimestep);
+
+  pendingTimestep = -1;
+}
+
+std::shared_ptr<sg::World> TimeSeriesWindow::timestepWorld(
+    int variableNum, int timestep)
+{
+  auto &world = importAsSeparateTimeseries
+      ? g_allSeparateWorlds[variableNum][timestep]
+      : g_allWorlds[timestep];
+
+  if (world)
+    return world;
+
+  world = std::static_pointer_cast<sg::World>(createNode("world", "world"));
+
+  auto addVariable = [&](int i, float offset) {
+    auto &timestepVolume = timestepVolumes[i][timestep];
+    auto vol = timestepVolume.createSGVolume();
+
+    auto tfn = std::static_pointer_cast<sg::TransferFunction>(
+        sg::createNode("tfn_" + to_string(i), "transfer_function_cloud"));
+
+    // quantized voxels are stored as q = (value - offset) / scale
+    auto raw = timestepVolume.raw;
+    if (raw && !raw->localLoading && raw->quantizeBits != 32) {
+      auto range = tfn->child("valueRange").valueAs<vec2f>();
+      tfn->child("valueRange") =
+          (range - raw->quantizeOffset) / raw->quantizeScale;
+
+      const float valueRange = raw->quantizeScale
+          * (raw->quantizeBits == 8 ? 255.f : 65535.f);
+      std::cout << "variable " << i << " timestep " << timestep << ": "
+                << raw->quantizeBits << " bit, max error "
+                << raw->quantizeError;
+      if (valueRange > 0.f)
+        std::cout << " (" << 100.f * raw->quantizeError / valueRange
+                  << "% of value range)";
+      std::cout << std::endl;
+    }
+
+    for (int j = 0; j < numInstances; j++) {
+      auto newX = createNode("geomXfm" + to_string(j), "transform");
+      newX->child("translation") = vec3f(j + 20 * j + offset, 0, 0);
+      newX->add(vol);
+      tfn->add(newX);
+    }
+
+    world->add(tfn);
+  };
+
+  if (importAsSeparateTimeseries) {
+    addVariable(variableNum, variableNum);
+  } else {
+    for (size_t i = 0; i < allVariablesData.size(); i++)
+      addVariable(i, i * 10);
+  }
+
+  world->render();
+
+  return world;
 }
 
 bool variableUI_callback(void *, int index, const char **out_text)
@@ -122,162 +307,26 @@ void TimeSeriesWindow::mainLoop()
   activeWindow->lightTypeStr = lightTypeStr;
   lightsManager->removeLight("ambient");
 
-  if (!importAsSeparateTimeseries) {
-    // generate one world per timestep
-    for (size_t i = 0; i < allVariablesData[0].size(); i++) {
-      auto world = std::static_pointer_cast<ospray::sg::World>(
-          createNode("world", "world"));
-      g_allWorlds.push_back(world);
-    }
-
-    // pre generate volumes/data for every timestep/world
-    for (size_t i = 0; i < allVariablesData.size(); i++) {
-      rkcommon::FileName fileName(allVariablesData[i][0]);
-      size_t lastindex = fileName.base().find_first_of(".");
-      variablesLoaded.push_back(fileName.base().substr(0, lastindex));
-
-      for (size_t f = 0; f < allVariablesData[i].size(); f++) {
-        std::shared_ptr<sg::Volume> vol;
-
-        if (allVariablesData[i][f].length() > 4
-            && allVariablesData[i][f].substr(
-                   allVariablesData[i][f].length() - 4)
-                == ".vdb") {
-          auto vdbVolumeTimestep = VDBVolumeTimestep(allVariablesData[i][f]);
-          vdbVolumeTimestep.localLoading = g_localLoading;
-          vdbVolumeTimestep.variableNum = i;
-
-          if (!g_localLoading && !isTimestepVolumeLoaded(i, f)) {
-            vdbVolumeTimestep.queueGenerateVolumeData();
-            vdbVolumeTimestep.waitGenerateVolumeData();
-          }
-
-          vol = vdbVolumeTimestep.createSGVolume();
-          vol->child("anisotropy").setValue(0.875f);
-          vol->child("densityScale").setValue(1.f);
-
-        } else {
-          if (dimensions.x == -1 || gridSpacing.x == -1) {
-            throw std::runtime_error(
-                "improper dimensions or grid spacing specified for volume");
-          }
-          if (voxelType == 0)
-            throw std::runtime_error("improper voxelType specified for volume");
-
-          auto volumeTimestep = VolumeTimestep(allVariablesData[i][f],
-              voxelType,
-              dimensions,
-              gridOrigin,
-              gridSpacing);
-          volumeTimestep.localLoading = g_localLoading;
-          volumeTimestep.variableNum = i;
-
-          if (!g_localLoading && !isTimestepVolumeLoaded(i, f)) {
-            volumeTimestep.queueGenerateVolumeData();
-            volumeTimestep.waitGenerateVolumeData();
-          }
-
-          vol = volumeTimestep.createSGVolume();
-        }
-
-        auto tfn = std::static_pointer_cast<sg::TransferFunction>(
-            sg::createNode("tfn_" + to_string(i), "transfer_function_cloud"));
-
-        for (int j = 0; j < numInstances; j++) {
-          auto newX = createNode("geomXfm" + to_string(j), "transform");
-          newX->child("translation") = vec3f(j + 20 * j + i * 10, 0, 0);
-          newX->add(vol);
-          tfn->add(newX);
-        }
-
-        auto &world = g_allWorlds[f];
-
-        world->add(tfn);
-        world->render();
-      }
-    }
-  } else {
-    // pre generate volumes/data for every timestep/world
-    for (size_t i = 0; i < allVariablesData.size(); i++) {
-      rkcommon::FileName fileName(allVariablesData[i][0]);
-      size_t lastindex = fileName.base().find_first_of(".");
-      variablesLoaded.push_back(fileName.base().substr(0, lastindex));
-
-      // single variable world vector
-      std::vector<std::shared_ptr<sg::World>> singleVariableWorlds;
-
-      for (size_t f = 0; f < allVariablesData[i].size(); f++) {
-        auto world = std::static_pointer_cast<ospray::sg::World>(
-            createNode("world", "world"));
-        singleVariableWorlds.push_back(world);
-
-        std::shared_ptr<sg::Volume> vol;
-
-        if (allVariablesData[i][f].length() > 4
-            && allVariablesData[i][f].substr(
-                   allVariablesData[i][f].length() - 4)
-                == ".vdb") {
-          auto vdbVolumeTimestep = VDBVolumeTimestep(allVariablesData[i][f]);
-          vdbVolumeTimestep.localLoading = g_localLoading;
-          vdbVolumeTimestep.variableNum = i;
-
-          if (!g_localLoading) {
-            vdbVolumeTimestep.queueGenerateVolumeData();
-            vdbVolumeTimestep.waitGenerateVolumeData();
-          }
-
-          vol = vdbVolumeTimestep.createSGVolume();
-          vol->child("anisotropy").setValue(0.875f);
-          vol->child("densityScale").setValue(1.f);
-
-        } else {
-          if (dimensions.x == -1 || gridSpacing.x == -1) {
-            throw std::runtime_error(
-                "improper dimensions or grid spacing specified for volume");
-          }
-          if (voxelType == 0)
-            throw std::runtime_error("improper voxelType specified for volume");
-
-          auto volumeTimestep = VolumeTimestep(allVariablesData[i][f],
-              voxelType,
-              dimensions,
-              gridOrigin,
-              gridSpacing);
-          volumeTimestep.localLoading = g_localLoading;
-          volumeTimestep.variableNum = i;
-
-          if (!g_localLoading) {
-            volumeTimestep.queueGenerateVolumeData();
-            volumeTimestep.waitGenerateVolumeData();
-          }
-
-          vol = volumeTimestep.createSGVolume();
-        }
+  for (size_t i = 0; i < allVariablesData.size(); i++) {
+    rkcommon::FileName fileName(allVariablesData[i][0]);
+    size_t lastindex = fileName.base().find_first_of(".");
+    variablesLoaded.push_back(fileName.base().substr(0, lastindex));
+  }
 
-        auto tfn = std::static_pointer_cast<sg::TransferFunction>(
-            sg::createNode("tfn_" + to_string(i), "transfer_function_cloud"));
+  createTimestepVolumes();
 
-        for (int j = 0; j < numInstances; j++) {
-          auto newX = createNode("geomXfm" + to_string(j), "transform");
-          newX->child("translation") = vec3f(j + 20 * j + i, 0, 0);
-          newX->add(vol);
-          tfn->add(newX);
-        }
+  // worlds are created the first time their timestep is displayed
+  if (!importAsSeparateTimeseries)
+    g_allWorlds.resize(numTimesteps);
+  else
+    for (auto &variableData : allVariablesData)
+      g_allSeparateWorlds.emplace_back(variableData.size());
 
-        world->add(tfn);
-        world->render();
-      }
-      g_allSeparateWorlds.push_back(singleVariableWorlds);
-    }
-  }
+  // start reading in the background, only the first timestep is waited on
+  updateLoaders();
 
-  if (importAsSeparateTimeseries) {
-    arcballCamera.reset(
-        new ArcballCamera(g_allSeparateWorlds[0][0]->bounds(), windowSize));
-  } else {
-    arcballCamera.reset(
-        new ArcballCamera(g_allWorlds[0]->bounds(), windowSize));
-  }
+  arcballCamera.reset(
+      new ArcballCamera(timestepWorld(0, 0)->bounds(), windowSize));
   activeWindow->updateCamera();
 
   // set initial timestep
@@ -288,8 +337,11 @@ void TimeSeriesWindow::mainLoop()
 
   activeWindow->registerImGuiCallback([&]() { addTimeseriesUI(); });
 
-  activeWindow->registerDisplayCallback(
-      [&](MainWindow *) { animateTimesteps(); });
+  activeWindow->registerDisplayCallback([&](MainWindow *) {
+    updateLoaders();
+    showPendingTimestep();
+    animateTimesteps();
+  });
 
   activeWindow->mainLoop();
 }
@@ -407,12 +459,24 @@ bool TimeSeriesWindow::parseCommandLine()
       }
 
       allVariablesData.push_back(singleVariableData);
+      variableQuantizeBits.push_back(quantizeBits);
+    }
+
+    else if (switchArg == "-quantize") {
+      quantizeBits = stoi(std::string(argv[argIndex++]));
+      if (quantizeBits != 8 && quantizeBits != 16 && quantizeBits != 32) {
+        throw std::runtime_error("improper -quantize bits, use 8, 16 or 32");
+      }
     }
 
     else if (switchArg == "-localLoading") {
       g_localLoading = true;
     } 
     
+    else if (switchArg == "-maxLoaders") {
+      maxLoaders = stoi(std::string(argv[argIndex++]));
+    }
+
     else if (switchArg == "-separateFb") {
       setSeparateFramebuffers = true;
     } 
@@ -447,7 +511,7 @@ void TimeSeriesWindow::addTimeseriesUI()
                      nullptr,
                      g_allSeparateWorlds.size())) {
       frame->cancelFrame();
-      setVariableTimeseries(whichVariable, 0);
+      requestTimestep(0);
     }
     numTimesteps = g_allSeparateWorlds[whichVariable].size();
   } else {
@@ -474,13 +538,36 @@ void TimeSeriesWindow::setTimestepsUI(int numTimesteps){
                        &g_timeseriesParameters.currentTimestep,
                        0,
                        numTimesteps - 1)) {
-    if (importAsSeparateTimeseries)
-      setVariableTimeseries(whichVariable,
-                            g_timeseriesParameters.currentTimestep);
-    else
-      setTimestep(g_timeseriesParameters.currentTimestep);
+    requestTimestep(g_timeseriesParameters.currentTimestep);
   }
 
+  // one cell per timestep, lit once its files have been read
+  int numReady = 0;
+  const float stripWidth = ImGui::CalcItemWidth();
+  const float cellWidth = stripWidth / numTimesteps;
+  const float cellHeight = 6.f;
+  const ImVec2 stripPos = ImGui::GetCursorScreenPos();
+  ImDrawList *drawList = ImGui::GetWindowDrawList();
+
+  for (int t = 0; t < numTimesteps; t++) {
+    const bool ready = isTimestepReady(t);
+    numReady += ready;
+
+    ImU32 color =
+        ready ? IM_COL32(90, 180, 90, 255) : IM_COL32(80, 80, 80, 255);
+    if (t == g_timeseriesParameters.currentTimestep)
+      color = IM_COL32(230, 230, 230, 255);
+
+    const float gap = cellWidth > 3.f ? 1.f : 0.f;
+    drawList->AddRectFilled(ImVec2(stripPos.x + t * cellWidth, stripPos.y),
+        ImVec2(stripPos.x + (t + 1) * cellWidth - gap, stripPos.y + cellHeight),
+        color);
+  }
+  ImGui::Dummy(ImVec2(stripWidth, cellHeight));
+
+  if (numReady < numTimesteps)
+    ImGui::Text("loading timesteps: %d / %d", numReady, numTimesteps);
+
   ImGui::InputInt("Timesteps per second",
                   &g_timeseriesParameters.desiredTimestepsPerSecond);
 
@@ -561,20 +648,23 @@ void TimeSeriesWindow::animateTimesteps()
     std::chrono::duration<double> elapsedSeconds = now - timestepLastChanged;
 
     if (elapsedSeconds.count() > minChangeInterval) {
-      g_timeseriesParameters.currentTimestep +=
-          g_timeseriesParameters.animationIncrement;
+      int nextTimestep = g_timeseriesParameters.currentTimestep
+          + g_timeseriesParameters.animationIncrement;
 
-      if (g_timeseriesParameters.currentTimestep <
-          g_timeseriesParameters.computedAnimationMin) {
-        g_timeseriesParameters.currentTimestep =
-            g_timeseriesParameters.computedAnimationMin;
+      if (nextTimestep < g_timeseriesParameters.computedAnimationMin) {
+        nextTimestep = g_timeseriesParameters.computedAnimationMin;
       }
 
-      if (g_timeseriesParameters.currentTimestep >
-          g_timeseriesParameters.computedAnimationMax) {
-        g_timeseriesParameters.currentTimestep =
-            g_timeseriesParameters.computedAnimationMin;
+      if (nextTimestep > g_timeseriesParameters.computedAnimationMax) {
+        nextTimestep = g_timeseriesParameters.computedAnimationMin;
       }
+
+      // hold the current timestep until the next one has been read
+      if (!isTimestepReady(nextTimestep))
+        return;
+
+      g_timeseriesParameters.currentTimestep = nextTimestep;
+      pendingTimestep = -1;
       if (importAsSeparateTimeseries)
         setVariableTimeseries(whichVariable,
                               g_timeseriesParameters.currentTimestep);
@@ -631,7 +721,7 @@ void TimeSeriesWindow::resetAccumulation()
 void TimeSeriesWindow::setVariableTimeseries(int whichVariable, int timestep)
 {
   auto frame = activeWindow->getFrame();
-  auto world = g_allSeparateWorlds[whichVariable][timestep];
+  auto world = timestepWorld(whichVariable, timestep);
   frame->add(world);
 
   frame->childAs<FrameBuffer>("framebuffer").resetAccumulation();
@@ -644,7 +734,7 @@ void TimeSeriesWindow::setVariableTimeseries(int whichVariable, int timestep)
 void TimeSeriesWindow::setTimestep(int timestep)
 {
   auto frame = activeWindow->getFrame();
-  auto world = g_allWorlds[timestep];
+  auto world = timestepWorld(0, timestep);
   lightsManager->updateWorld(*world);
   frame->add(world); 
 
@@ -667,6 +757,9 @@ void TimeSeriesWindow::printHelp()
     -separateTimeseries add volume variables as separate dropdown selectable timeseries
     -separateFb     configure separate Framebuffer per timestep
     -localLoading   to disable asynchronous loading of timesteps
+    -maxLoaders     <number of timestep files read concurrently> (default 4)
+    -quantize       8 | 16 | 32 store following -variable raw volumes as 8/16 bit
+                    with per timestep scale and offset (32 = float, default)
     -numInstances   <number of instances>
     -renderer       pathtracer | scivis
     -dimensions     <dimX> <dimY> <dimZ>
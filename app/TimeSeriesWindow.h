@@ -13,6 +13,8 @@
 #include "sg/scene/World.h"
 #include "sg/renderer/Renderer.h"
 #include "sg/visitors/PrintNodes.h"
+#include "sg/scene/volume/VDBVolumeTimeStep.h"
+#include "sg/scene/volume/VolumeTimeStep.h"
 
 using namespace std;
 
@@ -45,6 +47,18 @@ class TimeSeriesWindow : public MainWindow
 
   void setVariableTimeseries(int whichVariable, int timestep);
 
+  // World showing the given timestep, created on first use
+  std::shared_ptr<ospray::sg::World> timestepWorld(
+      int variableNum, int timestep);
+
+  // Keeps up to maxLoaders timestep files reading in the background
+  void updateLoaders();
+
+  // Shows the timestep once its files have been read, reading them next.
+  // The timestep shown so far stays up until then.
+  void requestTimestep(int timestep);
+  void showPendingTimestep();
+
   void printHelp() override;
 
   std::vector<ospray::sg::VolumeParameters> g_volumeParameters;
@@ -54,6 +68,10 @@ class TimeSeriesWindow : public MainWindow
 
   std::vector<std::vector<std::string>> allVariablesData;
 
+  // per variable 8/16 bit voxel storage, 32 keeps floats
+  std::vector<int> variableQuantizeBits;
+  int quantizeBits{32};
+
   // for each variable, time series of volume time steps
   int argIndex = 1;
   int voxelType;
@@ -94,6 +112,8 @@ class TimeSeriesWindow : public MainWindow
 
   bool isTimestepVolumeLoaded(int variableNum, size_t timestep);
 
+  bool isTimestepReady(int timestep);
+
  protected:
   float framebufferScale = 1.f;
   vec2i framebufferSize;
@@ -123,4 +143,31 @@ class TimeSeriesWindow : public MainWindow
 
   bool g_localLoading{false};
   bool g_lowResMode;
+
+  // Volume data of one variable at one timestep.  Files are read in the
+  // background, the sg::Volume is only created once a world needs it.
+  struct TimestepVolume
+  {
+    std::shared_ptr<ospray::sg::VolumeTimestep> raw;
+    std::shared_ptr<ospray::sg::VDBVolumeTimestep> vdb;
+    bool queued{false};
+
+    void queue();
+    bool ready() const;
+    std::shared_ptr<ospray::sg::Volume> createSGVolume();
+  };
+
+  void createTimestepVolumes();
+
+  // per variable, per timestep
+  std::vector<std::vector<TimestepVolume>> timestepVolumes;
+
+  // (variable, timestep) in the order they are read, timestep major
+  std::vector<std::pair<int, int>> loadOrder;
+  size_t nextToLoad{0};
+  std::vector<TimestepVolume *> loading;
+  int maxLoaders{4};
+
+  // requested timestep of whichVariable, -1 if it is shown
+  int pendingTimestep{-1};
 };
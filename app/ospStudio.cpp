@@ -5,7 +5,9 @@
 
 #include "MainWindow.h"
 #include "Batch.h"
+#include "Benchmark.h"
 #include "TimeSeriesWindow.h"
+#include "sg/Profiler.h"
 
 using namespace ospray;
 using rkcommon::removeArgs;
@@ -14,10 +16,13 @@ int main(int argc, const char *argv[])
 {
   std::cout << "OSPRay Studio" << std::endl;
 
-  // Just look for either version or verify_install arguments, initializeOSPRay
-  // will remove OSPRay specific args, parse fully down further
+  // Just look for version, verify_install or profile arguments,
+  // initializeOSPRay will remove OSPRay specific args, parse fully down further
+  // --profile <trace.json> records scoped timers, written as a Chrome trace
+  // on exit
   bool version = false;
   bool verify_install = false;
+  std::string profileFile;
   for (int i = 1; i < argc; i++) {
     const auto arg = std::string(argv[i]);
     if (arg == "--version") {
@@ -28,8 +33,16 @@ int main(int argc, const char *argv[])
       verify_install = true;
       removeArgs(argc, argv, i, 1);
     }
+    else if (arg == "--profile" && i + 1 < argc) {
+      profileFile = argv[i + 1];
+      removeArgs(argc, argv, i, 2);
+      --i;
+    }
   }
 
+  if (!profileFile.empty())
+    sg::Profiler::setEnabled(true);
+
   if (version) {
     std::cout << " OSPRay Studio version: " << OSPRAY_STUDIO_VERSION
               << std::endl;
@@ -103,6 +116,9 @@ int main(int argc, const char *argv[])
     case StudioMode::TIMESERIES:
       context = std::make_shared<TimeSeriesWindow>(studioCommon);
       break;
+    case StudioMode::BENCHMARK:
+      context = std::make_shared<BenchmarkContext>(studioCommon);
+      break;
     default:
       std::cerr << "unknown mode!  How did I get here?!\n";
     }
@@ -113,6 +129,11 @@ int main(int argc, const char *argv[])
       std::cerr << "Could not create a valid context. Stopping." << std::endl;
   }
 
+  if (sg::Profiler::enabled()) {
+    sg::Profiler::printSummary(std::cout);
+    sg::Profiler::writeChromeTrace(profileFile);
+  }
+
   ospShutdown();
 
   return 0;
@@ -29,14 +29,16 @@ enum class StudioMode
   GUI,
   BATCH,
   HEADLESS,
-  TIMESERIES
+  TIMESERIES,
+  BENCHMARK
 };
 
 const static std::map<std::string, StudioMode> StudioModeMap = {
     {"gui", StudioMode::GUI},
     {"batch", StudioMode::BATCH},
     {"server", StudioMode::HEADLESS},
-    {"timeseries", StudioMode::TIMESERIES}};
+    {"timeseries", StudioMode::TIMESERIES},
+    {"benchmark", StudioMode::BENCHMARK}};
 
 // Common across all modes
 
@@ -91,6 +93,10 @@ class StudioContext : public std::enable_shared_from_this<StudioContext>
   std::shared_ptr<sg::LightsManager> lightsManager;
 
   std::vector<std::string> filesToImport;
+  // model bounds a scene file declares, by file, see sg::importScene()
+  std::map<std::string, box3f> importBounds;
+  // the scene file overrides model materials, so nothing may be deferred
+  bool sceneMaterials{false};
   std::unique_ptr<ArcballCamera> arcballCamera;
 
   int defaultMaterialIdx = 0;
@@ -4,6 +4,8 @@
 #pragma once
 
 #include "Node.h"
+// std
+#include <memory>
 
 namespace ospray {
   namespace sg {
@@ -58,12 +60,45 @@ namespace ospray {
          const vec3ul &numItems,
          bool isShared = false);
 
+    // Take ownership of a container and share its memory with OSPRay, so no
+    // copy is made.  The elements live as long as the node does.
+
+    template <typename T, typename ALLOC_T>
+    Data(std::vector<T, ALLOC_T> &&arr);
+
+    template <typename T, typename ALLOC_T>
+    Data(std::vector<T, ALLOC_T> &&arr, const vec2ul &numItems);
+
+    template <typename T, typename ALLOC_T>
+    Data(std::vector<T, ALLOC_T> &&arr, const vec3ul &numItems);
+
+    // Share init with OSPRay and keep owner, whatever buffer init points into,
+    // alive with the node
+
+    template <typename T>
+    Data(size_t numItems, const T *init, std::shared_ptr<void> owner);
+
+    template <typename T>
+    Data(const vec2ul &numItems, const T *init, std::shared_ptr<void> owner);
+
+    template <typename T>
+    Data(const vec3ul &numItems, const T *init, std::shared_ptr<void> owner);
+
     // Set a single object as a 1-item data array
 
     template <typename T>
     Data(const T &obj);
 
+    // Size of the array, for memory accounting.  Shared arrays reference
+    // application memory or ownedData, sharedData, instead of holding a copy.
+    size_t numBytes{0};
+    const void *sharedData{nullptr};
+    std::shared_ptr<void> ownedData;
+
    private:
+    template <typename T, typename ALLOC_T>
+    Data(std::shared_ptr<std::vector<T, ALLOC_T>> arr, const vec3ul &numItems);
+
     template <typename T>
     void validate_element_type();
   };
@@ -139,8 +174,12 @@ namespace ospray {
       ospObject = ospNewData(format, numItems.x, numItems.y, numItems.z);
       ospCopyData(tmp, ospObject);
       ospRelease(tmp);
+    } else {
+      sharedData = init;
     }
 
+    numBytes = numItems.x * numItems.y * numItems.z * sizeof(T);
+
     setValue(cpp::CopiedData(ospObject));
   }
 
@@ -176,6 +215,57 @@ namespace ospray {
     validate_element_type<T>();
   }
 
+  template <typename T, typename ALLOC_T>
+  inline Data::Data(std::vector<T, ALLOC_T> &&arr)
+      : Data(std::move(arr), vec3ul(arr.size(), 1, 1))
+  {
+  }
+
+  template <typename T, typename ALLOC_T>
+  inline Data::Data(std::vector<T, ALLOC_T> &&arr, const vec2ul &numItems)
+      : Data(std::move(arr), vec3ul(numItems.x, numItems.y, 1))
+  {
+  }
+
+  template <typename T, typename ALLOC_T>
+  inline Data::Data(std::vector<T, ALLOC_T> &&arr, const vec3ul &numItems)
+      : Data(std::make_shared<std::vector<T, ALLOC_T>>(std::move(arr)),
+             numItems)
+  {
+  }
+
+  template <typename T, typename ALLOC_T>
+  inline Data::Data(std::shared_ptr<std::vector<T, ALLOC_T>> arr,
+                    const vec3ul &numItems)
+      : Data(numItems, arr->data(), std::shared_ptr<void>(arr))
+  {
+  }
+
+  template <typename T>
+  inline Data::Data(size_t numItems,
+                    const T *init,
+                    std::shared_ptr<void> owner)
+      : Data(vec3ul(numItems, 1, 1), init, std::move(owner))
+  {
+  }
+
+  template <typename T>
+  inline Data::Data(const vec2ul &numItems,
+                    const T *init,
+                    std::shared_ptr<void> owner)
+      : Data(vec3ul(numItems.x, numItems.y, 1), init, std::move(owner))
+  {
+  }
+
+  template <typename T>
+  inline Data::Data(const vec3ul &numItems,
+                    const T *init,
+                    std::shared_ptr<void> owner)
+      : Data(numItems, vec3ul(0), init, true)
+  {
+    ownedData = std::move(owner);
+  }
+
   template <typename T>
   inline Data::Data(const T &obj) : Data(1, &obj)
   {
@@ -7,6 +7,7 @@
 #include "sg/fb/FrameBuffer.h"
 #include "sg/renderer/Renderer.h"
 #include "sg/scene/World.h"
+#include "Profiler.h"
 
 namespace ospray {
   namespace sg {
@@ -35,15 +36,24 @@ namespace ospray {
 
   void Frame::startNewFrame(bool interacting)
   {
-    auto &fb = childAs<FrameBuffer>("frameBuffer");
+    auto &fb = childAs<FrameBuffer>("framebuffer");
     auto &camera = childAs<Camera>("camera");
     auto &renderer = childAs<Renderer>("renderer");
     auto &world = childAs<World>("world");
 
     refreshFrameOperations();
 
-    // If working on a frame, cancel it, something has changed
-    if (isModified()) {
+    // Image operation edits (e.g. tone mapper exposure) are applied to the
+    // accumulated samples, so the frame isn't reset and navMode not entered
+    const bool imageOpsOnly = isModified() && onlyImageOpsModified();
+
+    if (imageOpsOnly) {
+      // The framebuffer can't be committed under the frame in flight.  Leave
+      // the edit pending until the frame is ready rather than waiting on it.
+      if (future && !frameIsReady())
+        return;
+    } else if (isModified()) {
+      // If working on a frame, cancel it, something has changed
       cancelFrame();
       fb.resetAccumulation();
       // Enable navMode
@@ -56,14 +66,20 @@ namespace ospray {
     }
 
     // Commit only when modified and not while interacting.
-    if (isModified() && !interacting)
+    if (isModified() && !interacting) {
+      SG_PROFILE_SCOPE("Frame::commit");
       commit();
+      updateNavCulling();
+    }
 
-    if (!(interacting || pauseRendering || accumLimitReached())) {
-      auto future = fb.handle().renderFrame(
+    // A converged image still needs a frame to show the new image operations
+    if (!(interacting || pauseRendering
+            || (accumLimitReached() && !imageOpsOnly))) {
+      SG_PROFILE_SCOPE("renderFrame");
+      // The future is kept out of the node value, storing it must not mark
+      // the frame modified
+      future = fb.handle().renderFrame(
           renderer.handle(), camera.handle(), world.handle());
-      setHandle(future);
-      commit(); // XXX setHandle modifies node, but nothing else has changed yet
       canceled = false;
 
       if (immediatelyWait)
@@ -73,7 +89,6 @@ namespace ospray {
 
   bool Frame::frameIsReady()
   {
-    auto future = value().valid() ? handle() : nullptr;
     if (future)
       return future.isReady();
     else
@@ -82,7 +97,6 @@ namespace ospray {
 
   float Frame::frameProgress()
   {
-    auto future = value().valid() ? handle() : nullptr;
     if (future)
       return future.progress();
     else
@@ -91,7 +105,7 @@ namespace ospray {
 
   void Frame::waitOnFrame()
   {
-    auto future = value().valid() ? handle() : nullptr;
+    SG_PROFILE_SCOPE("waitOnFrame");
     if (future)
       future.wait();
     if (!accumLimitReached())
@@ -100,7 +114,6 @@ namespace ospray {
 
   void Frame::cancelFrame()
   {
-    auto future = value().valid() ? handle() : nullptr;
     if (future) {
       future.cancel();
       canceled = true;
@@ -142,6 +155,39 @@ namespace ospray {
     fb.updateImageOperations();
   }
 
+  void Frame::updateNavCulling()
+  {
+    auto &world = childAs<World>("world");
+
+    bool changed = false;
+    if (navMode && (cullNav || lodNavPixels > 0.f)) {
+      changed = world.cullInstances(child("camera"),
+          child("framebuffer")["size"].valueAs<vec2i>(),
+          cullNav,
+          cullNav ? cullNavPixels : 0.f,
+          lodNavPixels);
+    } else
+      changed = world.uncullInstances();
+
+    if (changed) {
+      SG_PROFILE_SCOPE("ospCommit world");
+      world.handle().commit();
+    }
+  }
+
+  bool Frame::onlyImageOpsModified()
+  {
+    if (lastModified() > lastCommitted())
+      return false;
+
+    for (auto &c : children()) {
+      if (c.first != "framebuffer" && c.second->isModified())
+        return false;
+    }
+
+    return childAs<FrameBuffer>("framebuffer").onlyImageOpsModified();
+  }
+
   void Frame::preCommit()
   {
     static bool currentNavMode = navMode;
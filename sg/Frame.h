@@ -39,6 +39,14 @@ namespace ospray {
     void unmapFrame(void *mem);
     void saveFrame(std::string filename, int flags);
 
+    // While navigating, leave out instances outside the view or smaller than
+    // cullNavPixels and render those smaller than lodNavPixels with their
+    // simplified stand-in, see World::cullInstances().  Final frames always
+    // render every instance in full.
+    bool cullNav{false};
+    float cullNavPixels{1.f};
+    float lodNavPixels{0.f};
+
     bool immediatelyWait{false};
     bool pauseRendering{false};
     int accumLimit{0};
@@ -46,8 +54,11 @@ namespace ospray {
     bool canceled{false};
 
    private:
+    cpp::Future future{nullptr};
     bool navMode{false};
     void refreshFrameOperations();
+    void updateNavCulling();
+    bool onlyImageOpsModified();
     void preCommit() override;
     void postCommit() override;
   };
@@ -37,6 +37,8 @@ inline void to_json(JSON &j, const AffineSpace3f &as);
 inline void from_json(const JSON &j, AffineSpace3f &as);
 inline void to_json(JSON &j, const quaternionf &q);
 inline void from_json(const JSON &j, quaternionf &q);
+inline void to_json(JSON &j, const box3f &b);
+inline void from_json(const JSON &j, box3f &b);
 } // namespace math
 namespace utility {
 void to_json(JSON &j, const Any &a);
@@ -71,7 +73,12 @@ inline void to_json(JSON &j, const Node &n)
   // we only want the importer and its root transform, not the hierarchy of
   // geometry under it
   if (n.type() == NodeType::IMPORTER) {
-    j["filename"] = n.nodeAs<const Importer>()->getFileName().str();
+    auto importer = n.nodeAs<const Importer>();
+    j["filename"] = importer->getFileName().str();
+    // lets a scene load the model lazily, see Importer::deferImport()
+    const box3f bounds = importer->modelBounds();
+    if (!bounds.empty())
+      j["bounds"] = bounds;
     for (auto &child : n.children()) {
       if (child.second->type() == NodeType::TRANSFORM) {
         j["children"] = {*child.second};
@@ -255,6 +262,17 @@ inline void from_json(const JSON &j, quaternionf &q)
   j.at("k").get_to(q.k);
 }
 
+inline void to_json(JSON &j, const box3f &b)
+{
+  j = JSON{{"lower", b.lower}, {"upper", b.upper}};
+}
+
+inline void from_json(const JSON &j, box3f &b)
+{
+  j.at("lower").get_to(b.lower);
+  j.at("upper").get_to(b.upper);
+}
+
 } // namespace math
 
 namespace utility {
@@ -3,11 +3,13 @@
 
 #include "Node.h"
 #include "visitors/Commit.h"
-#include "visitors/GetBounds.h"
 #include "visitors/RenderScene.h"
+#include "Profiler.h"
 // rkcommon
 #include "rkcommon/os/library.h"
 #include "rkcommon/utility/StringManip.h"
+// std
+#include <cctype>
 
 namespace ospray {
   namespace sg {
@@ -71,6 +73,17 @@ namespace ospray {
   // Parent-child structual interface /////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////
 
+  // Compares without lowercased copies, child lookups run for every add()
+  static inline bool equalsIgnoreCase(
+      const std::string &a, const std::string &b)
+  {
+    return a.size() == b.size()
+        && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+             return std::tolower(static_cast<unsigned char>(x))
+                 == std::tolower(static_cast<unsigned char>(y));
+           });
+  }
+
   const FlatMap<std::string, NodePtr> &Node::children() const
   {
     return properties.children;
@@ -82,10 +95,8 @@ namespace ospray {
     if (c.contains(name))
       return true;
 
-    std::string name_lower = utility::lowerCase(name);
-
     auto itr = std::find_if(c.cbegin(), c.cend(), [&](const NodeLink &n) {
-      return utility::lowerCase(n.first) == name_lower;
+      return equalsIgnoreCase(n.first, name);
     });
 
     return itr != properties.children.end();
@@ -97,10 +108,8 @@ namespace ospray {
     if (c.contains(name))
       return *c[name];
 
-    std::string name_lower = utility::lowerCase(name);
-
     auto itr = std::find_if(c.begin(), c.end(), [&](const NodeLink &n) {
-      return utility::lowerCase(n.first) == name_lower;
+      return equalsIgnoreCase(n.first, name);
     });
 
     if (itr == properties.children.cend()) {
@@ -156,7 +165,10 @@ namespace ospray {
     }
     properties.children[name] = node;
     node->properties.parents.push_back(this);
+    if (node->subtreeModifiedButNotCommitted())
+      properties.dirtyChildren.push_back(node.get());
     markAsModified();
+    markStructureModified();
   }
 
   void Node::remove(Node &node)
@@ -202,32 +214,39 @@ namespace ospray {
       remove(c.first);
   }
 
+  TimeStamp Node::structureLastModified() const
+  {
+    return properties.structureMTime;
+  }
+
   /////////////////////////////////////////////////////////////////////////////
   // Traveral Interface ///////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////
 
   void Node::commit()
   {
-    traverse<CommitVisitor>();
+    // Nothing changed, nothing to traverse
+    if (subtreeModifiedButNotCommitted())
+      commitDirtySubtree();
   }
 
   void Node::render()
   {
     commit();
+    SG_PROFILE_SCOPE("RenderScene");
     traverse<RenderScene>();
   }
 
   void Node::render(GeomIdMap &geomIdMap, InstanceIdMap &instanceIdMap)
   {
     commit();
+    SG_PROFILE_SCOPE("RenderScene");
     traverse<RenderScene>(geomIdMap, instanceIdMap);
   }
 
   box3f Node::bounds()
   {
-    GetBounds visitor;
-    traverse(visitor);
-    return visitor.bounds;
+    return childrenBounds();
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -304,9 +323,26 @@ namespace ospray {
     return properties.childrenMTime;
   }
 
+  box3f Node::childrenBounds()
+  {
+    box3f bounds{empty};
+    for (const auto &child : properties.children)
+      bounds.extend(child.second->bounds());
+    return bounds;
+  }
+
+  bool Node::modifiedSince(const TimeStamp &timeStamp) const
+  {
+    return properties.lastModified > timeStamp
+        || properties.childrenMTime > timeStamp;
+  }
+
   void Node::removeFromParentList(Node &node)
   {
     node.markAsModified(); // Removal requires notifying parents
+    node.markStructureModified();
+    auto &d = node.properties.dirtyChildren;
+    d.erase(std::remove(d.begin(), d.end(), this), d.end());
     auto &p          = properties.parents;
     auto remove_node = [&](auto np) { return np == &node; };
     p.erase(std::remove_if(p.begin(), p.end(), remove_node), p.end());
@@ -315,17 +351,68 @@ namespace ospray {
   void Node::markAsModified()
   {
     // Mark all parents, up to root, as modified
+    const bool wasClean = !subtreeModifiedButNotCommitted();
     properties.lastModified.renew();
     for (auto &p : properties.parents)
-      p->updateChildrenModifiedTime();
+      p->updateChildrenModifiedTime(*this, wasClean);
   }
 
-  void Node::updateChildrenModifiedTime()
+  void Node::updateChildrenModifiedTime(Node &child, bool childWasClean)
   {
+    // A child going from committed to modified is queued once, children
+    // already modified are on the dirty list since their first change
+    auto &d = properties.dirtyChildren;
+    if (childWasClean && (d.empty() || d.back() != &child))
+      d.push_back(&child);
+
     // Notify all parent of latest child modified time
+    const bool wasClean = !subtreeModifiedButNotCommitted();
     properties.childrenMTime.renew();
     for (auto &p : properties.parents)
-      p->updateChildrenModifiedTime();
+      p->updateChildrenModifiedTime(*this, wasClean);
+  }
+
+  // Profiler event names for commits, one per node type
+  static const char *commitEventName(NodeType type)
+  {
+    static const auto names = []() {
+      std::map<NodeType, std::string> n;
+      for (auto &t : NodeTypeToString)
+        n[t.first] = "commit " + t.second;
+      return n;
+    }();
+    return names.at(type).c_str();
+  }
+
+  void Node::commitDirtySubtree()
+  {
+    // Parameters are too small and too many to be worth a profiler event
+    SG_PROFILE_SCOPE(Profiler::enabled() && type() != NodeType::PARAMETER
+            ? commitEventName(type())
+            : nullptr);
+
+    preCommit();
+
+    // Children may be queued while committing siblings, index the live list
+    auto &d = properties.dirtyChildren;
+    for (size_t i = 0; i < d.size(); i++) {
+      if (d[i]->subtreeModifiedButNotCommitted())
+        d[i]->commitDirtySubtree();
+    }
+    d.clear();
+
+    postCommit();
+    properties.lastCommitted.renew();
+  }
+
+  void Node::markStructureModified()
+  {
+    // Structural changes are tracked separately from value changes so that
+    // cached views of the graph (e.g. NodeSnapshot) are only rebuilt when
+    // children are added or removed.
+    properties.structureMTime.renew();
+    for (auto &p : properties.parents)
+      p->markStructureModified();
   }
 
   void Node::setOSPRayParam(std::string, OSPObject) {}
@@ -157,6 +157,9 @@ namespace sg {
     void removeAllParents();
     void removeAllChildren();
 
+    // Latest add/remove of a child anywhere in this node's subtree
+    TimeStamp structureLastModified() const;
+
     template <typename... Args>
     Node &createChild(Args &&... args);
 
@@ -187,7 +190,11 @@ namespace sg {
     void render();
     void render(GeomIdMap &geomIdMap, InstanceIdMap &instanceIdMap);
 
-    box3f bounds();
+    // Bounds of this subtree.  Transforms, geometries, volumes and worlds
+    // cache their bounds and only recompute them after something below them
+    // was modified, other nodes combine the bounds of their children.  Never
+    // commits, geometries and volumes report the bounds of their last commit.
+    virtual box3f bounds();
 
     virtual void setOSPRayParam(std::string param, OSPObject handle);
 
@@ -226,16 +233,24 @@ namespace sg {
     TimeStamp childrenLastModified() const;
 
     void markAsModified();
-    void updateChildrenModifiedTime();
+    void updateChildrenModifiedTime(Node &child, bool childWasClean);
+    void markStructureModified();
 
     bool subtreeModifiedButNotCommitted() const;
     bool anyChildModified() const;
 
+    // Helpers for nodes caching their bounds
+    box3f childrenBounds();
+    bool modifiedSince(const TimeStamp &timeStamp) const;
+
    private:
     //! Use a custom provided node visitor to visit each node
     template <typename VISITOR_T>
     void traverse(VISITOR_T &&visitor, TraversalContext &ctx);
 
+    //! Commit this node, descending only into children on the dirty list
+    void commitDirtySubtree();
+
     //! Use a custom provided node visitor to visit each node
     template <typename VISITOR_T>
     void traverseAnimation(VISITOR_T &&visitor, TraversalContext &ctx);
@@ -258,9 +273,14 @@ namespace sg {
       FlatMap<std::string, NodePtr> children;
       std::vector<Node *> parents;
 
+      // Children which became modified since this node was last committed,
+      // filled by markAsModified() so commits only visit what changed
+      std::vector<Node *> dirtyChildren;
+
       TimeStamp whenCreated;
       TimeStamp lastModified;
       TimeStamp childrenMTime;
+      TimeStamp structureMTime;
       TimeStamp lastCommitted;
       TimeStamp lastVerified;
     } properties;
@@ -270,6 +290,7 @@ namespace sg {
     friend NodePtr OSPSG_INTERFACE createNode(std::string, std::string, std::string, Any);
 
     friend struct CommitVisitor;
+    friend struct NodeSnapshot;
   };
 
   /////////////////////////////////////////////////////////////////////////////
@@ -298,12 +298,12 @@ namespace ospray {
       return root;
 
     // Quick shallow top-level search first
-    for (auto child : root->children())
+    for (const auto &child : root->children())
       if (child.second->type() == nodeType)
         return child.second;
 
     // Next level, deeper search if not found
-    for (auto child : root->children()) {
+    for (const auto &child : root->children()) {
       found = findFirstNodeOfType(child.second, nodeType);
       if (found)
         return found;
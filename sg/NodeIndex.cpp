@@ -0,0 +1,237 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "NodeIndex.h"
+// std
+#include <algorithm>
+
+namespace ospray {
+namespace sg {
+
+static inline std::string childPath(
+    const std::string &path, const std::string &name)
+{
+  return path.empty() ? name : path + "/" + name;
+}
+
+static inline std::string nameOf(const std::string &path)
+{
+  return path.substr(path.rfind('/') + 1);
+}
+
+bool NodeIndex::update(Node &rootNode)
+{
+  if (root != &rootNode) {
+    clear();
+    root = &rootNode;
+  } else if (built && rootNode.structureLastModified() <= lastBuilt) {
+    return false;
+  }
+
+  updateChildren(rootNode, "", rootChildren);
+
+  built = true;
+  lastBuilt.renew();
+
+  return true;
+}
+
+void NodeIndex::clear()
+{
+  entries.clear();
+  rootChildren.clear();
+  byType.clear();
+  byID.clear();
+  byName.clear();
+  root = nullptr;
+  built = false;
+}
+
+NodePtr NodeIndex::find(const std::string &path) const
+{
+  auto found = entries.find(path);
+  return found == entries.end() ? nullptr : found->second.node.lock();
+}
+
+NodePtr NodeIndex::findByID(size_t uniqueID) const
+{
+  auto range = byID.equal_range(uniqueID);
+  for (auto i = range.first; i != range.second; ++i) {
+    auto node = find(*i->second);
+    if (node)
+      return node;
+  }
+  return nullptr;
+}
+
+std::vector<Node::NodeLink> NodeIndex::findByType(NodeType type) const
+{
+  std::vector<Node::NodeLink> nodes;
+
+  auto found = byType.find(type);
+  if (found == byType.end())
+    return nodes;
+
+  nodes.reserve(found->second.size());
+  for (auto *path : found->second) {
+    auto node = find(*path);
+    if (node)
+      nodes.emplace_back(*path, node);
+  }
+
+  return nodes;
+}
+
+std::vector<Node::NodeLink> NodeIndex::findByPrefix(
+    const std::string &prefix) const
+{
+  std::vector<Node::NodeLink> nodes;
+
+  for (auto i = entries.lower_bound(prefix);
+       i != entries.end() && i->first.compare(0, prefix.size(), prefix) == 0;
+       ++i) {
+    auto node = i->second.node.lock();
+    if (node)
+      nodes.emplace_back(i->first, node);
+  }
+
+  return nodes;
+}
+
+std::vector<Node::NodeLink> NodeIndex::findByName(
+    const std::string &name) const
+{
+  std::vector<const std::string *> paths;
+
+  auto range = byName.equal_range(name);
+  for (auto i = range.first; i != range.second; ++i)
+    paths.push_back(i->second);
+
+  return linksSortedByPath(paths);
+}
+
+std::vector<Node::NodeLink> NodeIndex::findByNamePrefix(
+    const std::string &prefix) const
+{
+  std::vector<const std::string *> paths;
+
+  for (auto i = byName.lower_bound(prefix);
+       i != byName.end() && i->first.compare(0, prefix.size(), prefix) == 0;
+       ++i)
+    paths.push_back(i->second);
+
+  return linksSortedByPath(paths);
+}
+
+std::vector<Node::NodeLink> NodeIndex::linksSortedByPath(
+    std::vector<const std::string *> &paths) const
+{
+  std::sort(paths.begin(),
+      paths.end(),
+      [](const std::string *a, const std::string *b) { return *a < *b; });
+
+  std::vector<Node::NodeLink> nodes;
+  nodes.reserve(paths.size());
+  for (auto *path : paths) {
+    auto node = find(*path);
+    if (node)
+      nodes.emplace_back(*path, node);
+  }
+
+  return nodes;
+}
+
+void NodeIndex::updateChildren(
+    Node &node, const std::string &path, std::vector<std::string> &indexed)
+{
+  const auto &children = node.children();
+
+  // Drop children which were removed or replaced by another node
+  for (auto &name : indexed) {
+    if (!children.contains(name))
+      eraseSubtree(childPath(path, name));
+  }
+  indexed.clear();
+  indexed.reserve(children.size());
+
+  for (auto &child : children) {
+    const auto path_c = childPath(path, child.first);
+    indexed.push_back(child.first);
+
+    auto found = entries.find(path_c);
+    if (found != entries.end() && found->second.node.lock() == child.second) {
+      // Same node as before, only descend if something below it changed
+      if (child.second->structureLastModified() > lastBuilt)
+        updateChildren(*child.second, path_c, found->second.children);
+    } else {
+      if (found != entries.end())
+        eraseSubtree(path_c);
+      insertSubtree(child.second, path_c);
+    }
+  }
+}
+
+void NodeIndex::insertSubtree(const NodePtr &node, const std::string &path)
+{
+  auto inserted = entries.emplace(path, Entry()).first;
+  const std::string *key = &inserted->first;
+
+  auto &entry = inserted->second;
+  entry.node = node;
+  entry.type = node->type();
+  entry.uniqueID = node->uniqueID();
+  entry.children.reserve(node->children().size());
+
+  byType[entry.type].insert(key);
+  byID.emplace(entry.uniqueID, key);
+  byName.emplace(nameOf(path), key);
+
+  for (auto &child : node->children()) {
+    entry.children.push_back(child.first);
+    insertSubtree(child.second, childPath(path, child.first));
+  }
+}
+
+void NodeIndex::eraseSubtree(const std::string &path)
+{
+  auto self = entries.find(path);
+  if (self != entries.end())
+    eraseEntry(self);
+
+  // All descendants share the "path/" prefix, which ends right before
+  // "path0" ('0' follows '/')
+  auto first = entries.lower_bound(path + "/");
+  auto last = entries.lower_bound(path + "0");
+  while (first != last)
+    eraseEntry(first++);
+}
+
+void NodeIndex::eraseEntry(EntryMap::iterator entry)
+{
+  const std::string *key = &entry->first;
+
+  auto type = byType.find(entry->second.type);
+  if (type != byType.end())
+    type->second.erase(key);
+
+  auto range = byID.equal_range(entry->second.uniqueID);
+  for (auto i = range.first; i != range.second; ++i) {
+    if (i->second == key) {
+      byID.erase(i);
+      break;
+    }
+  }
+
+  auto names = byName.equal_range(nameOf(*key));
+  for (auto i = names.first; i != names.second; ++i) {
+    if (i->second == key) {
+      byName.erase(i);
+      break;
+    }
+  }
+
+  entries.erase(entry);
+}
+
+} // namespace sg
+} // namespace ospray
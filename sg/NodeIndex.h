@@ -0,0 +1,102 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "Node.h"
+// std
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ospray {
+namespace sg {
+
+/////////////////////////////////////////////////////////////////////////////
+// Index of a (sub)graph by node path ///////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+// Maps the path of every node below a root, e.g.
+// "world/foo_importer/foo_rootXfm/mesh_0003", to the node.  Paths are built
+// from the child names used in the parents' children maps and do not
+// include the root itself.  A node's name is the last part of its path.  A
+// node with several parents is indexed once per path.
+//
+// update() only revisits subtrees whose structure changed since the last
+// update, so keeping the index current costs little when nodes are added or
+// removed in a large graph.  Nodes are held weakly, lookups of nodes removed
+// since the last update() return nullptr.
+
+struct OSPSG_INTERFACE NodeIndex
+{
+  NodeIndex() = default;
+  ~NodeIndex() = default;
+
+  // Bring the index up to date with root's subtree, returns true if
+  // anything had to be revisited
+  bool update(Node &root);
+
+  // Discard the index, forcing a full rebuild on the next update()
+  void clear();
+
+  NodePtr find(const std::string &path) const;
+  NodePtr findByID(size_t uniqueID) const;
+
+  // Nodes of a type, in no particular order
+  std::vector<Node::NodeLink> findByType(NodeType type) const;
+
+  // Nodes whose path starts with the prefix, sorted by path.  A prefix
+  // ending in '/' lists a whole subtree, "world/mesh_" all children of world
+  // named mesh_*, and their subtrees.
+  std::vector<Node::NodeLink> findByPrefix(const std::string &prefix) const;
+
+  // Nodes anywhere below the root with the name, or whose name starts with
+  // the prefix, e.g. "mesh_00", sorted by path
+  std::vector<Node::NodeLink> findByName(const std::string &name) const;
+  std::vector<Node::NodeLink> findByNamePrefix(
+      const std::string &prefix) const;
+
+  inline size_t size() const
+  {
+    return entries.size();
+  }
+
+  inline bool empty() const
+  {
+    return entries.empty();
+  }
+
+ private:
+  struct Entry
+  {
+    std::weak_ptr<Node> node;
+    NodeType type{NodeType::GENERIC};
+    size_t uniqueID{0};
+    // child names as indexed, used to find removed children
+    std::vector<std::string> children;
+  };
+
+  using EntryMap = std::map<std::string, Entry>;
+
+  void updateChildren(
+      Node &node, const std::string &path, std::vector<std::string> &indexed);
+  void insertSubtree(const NodePtr &node, const std::string &path);
+  void eraseSubtree(const std::string &path);
+  void eraseEntry(EntryMap::iterator entry);
+  std::vector<Node::NodeLink> linksSortedByPath(
+      std::vector<const std::string *> &paths) const;
+
+  EntryMap entries;
+  std::vector<std::string> rootChildren;
+  std::unordered_map<NodeType, std::unordered_set<const std::string *>>
+      byType;
+  std::unordered_multimap<size_t, const std::string *> byID;
+  std::multimap<std::string, const std::string *> byName;
+
+  Node *root{nullptr};
+  bool built{false};
+  TimeStamp lastBuilt;
+};
+
+} // namespace sg
+} // namespace ospray
@@ -0,0 +1,86 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "NodeSnapshot.h"
+
+namespace ospray {
+namespace sg {
+
+bool NodeSnapshot::update(Node &rootNode)
+{
+  if (root == &rootNode && !recordList.empty()
+      && rootNode.structureLastModified() <= lastBuilt)
+    return false;
+
+  // Keep the old records around so unchanged subtrees can be block copied
+  previous.swap(recordList);
+  previousIndex.clear();
+  if (root == &rootNode) {
+    previousIndex.reserve(previous.size());
+    for (uint32_t i = 0; i < previous.size(); i++)
+      previousIndex.emplace(previous[i].node, i);
+  }
+
+  recordList.clear();
+  recordList.reserve(previous.size());
+
+  root = &rootNode;
+  appendSubtree(rootNode, -1, 0);
+
+  previous.clear();
+  previousIndex.clear();
+  lastBuilt.renew();
+
+  return true;
+}
+
+void NodeSnapshot::clear()
+{
+  recordList.clear();
+  root = nullptr;
+}
+
+void NodeSnapshot::appendSubtree(Node &node, int32_t parent, int32_t level)
+{
+  const uint32_t index = recordList.size();
+
+  // Structure below this node is unchanged, copy its range of old records
+  // and shift their indices.
+  if (node.structureLastModified() <= lastBuilt) {
+    auto found = previousIndex.find(&node);
+    if (found != previousIndex.end()) {
+      const uint32_t oldIndex = found->second;
+      const auto &oldRoot = previous[oldIndex];
+      const int32_t indexShift = int32_t(index) - int32_t(oldIndex);
+      const int32_t levelShift = level - oldRoot.level;
+
+      recordList.insert(recordList.end(),
+          previous.begin() + oldIndex,
+          previous.begin() + oldIndex + oldRoot.subtreeSize);
+
+      recordList[index].parent = parent;
+      recordList[index].level = level;
+      for (uint32_t i = index + 1; i < recordList.size(); i++) {
+        recordList[i].parent += indexShift;
+        recordList[i].level += levelShift;
+      }
+      return;
+    }
+  }
+
+  Record r;
+  r.node = &node;
+  r.type = node.type();
+  r.parent = parent;
+  r.level = level;
+  r.value = &node.properties.value;
+  recordList.push_back(r);
+
+  for (auto &child : node.children())
+    appendSubtree(*child.second, index, level + 1);
+
+  recordList[index].subtreeSize = recordList.size() - index;
+}
+
+} // namespace sg
+} // namespace ospray
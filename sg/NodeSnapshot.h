@@ -0,0 +1,138 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "Node.h"
+// std
+#include <unordered_map>
+
+namespace ospray {
+namespace sg {
+
+/////////////////////////////////////////////////////////////////////////////
+// Flattened, read-only snapshot of a (sub)graph ////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+// The snapshot stores the graph below a root node as a pre-ordered array of
+// records, the same order Node::traverse() visits nodes in.  Every subtree
+// is a contiguous range of the array, so read-only visitors can iterate it
+// linearly without chasing child maps or copying NodePtrs.
+//
+// NOTE: Records hold raw Node pointers.  The snapshot must be brought up to
+//       date with update() before use after any structural change.
+
+struct OSPSG_INTERFACE NodeSnapshot
+{
+  struct Record
+  {
+    Node *node{nullptr};
+    NodeType type{NodeType::GENERIC};
+    int32_t parent{-1}; // index of parent record, -1 for the root
+    uint32_t subtreeSize{1}; // includes self, children are [i+1, i+size)
+    int32_t level{0};
+    const Any *value{nullptr};
+  };
+
+  NodeSnapshot() = default;
+  ~NodeSnapshot() = default;
+
+  // Rebuild the records if the structure of root's subtree changed since the
+  // last update.  Unchanged subtrees are copied from the previous snapshot.
+  // Returns true if anything was rebuilt.
+  bool update(Node &root);
+
+  // Discard the records, forcing a full rebuild on the next update()
+  void clear();
+
+  inline const std::vector<Record> &records() const
+  {
+    return recordList;
+  }
+
+  inline size_t size() const
+  {
+    return recordList.size();
+  }
+
+  inline bool empty() const
+  {
+    return recordList.empty();
+  }
+
+  // Iterate the children of the record at index i
+  template <typename FCN_T>
+  void forEachChild(uint32_t i, FCN_T &&fcn) const;
+
+  // Run a Visitor over the snapshot with the same semantics as
+  // Node::traverse() (visit, skip subtree on false, postChildren)
+  template <typename VISITOR_T>
+  void traverse(VISITOR_T &&visitor) const;
+
+ private:
+  void appendSubtree(Node &node, int32_t parent, int32_t level);
+
+  std::vector<Record> recordList;
+  Node *root{nullptr};
+  TimeStamp lastBuilt;
+
+  // Previous records, used as a source for unchanged subtrees during update
+  std::vector<Record> previous;
+  std::unordered_map<const Node *, uint32_t> previousIndex;
+};
+
+// Inlined definitions ////////////////////////////////////////////////////
+
+template <typename FCN_T>
+inline void NodeSnapshot::forEachChild(uint32_t i, FCN_T &&fcn) const
+{
+  const uint32_t end = i + recordList[i].subtreeSize;
+  for (uint32_t c = i + 1; c < end; c += recordList[c].subtreeSize)
+    fcn(recordList[c], c);
+}
+
+template <typename VISITOR_T>
+inline void NodeSnapshot::traverse(VISITOR_T &&visitor) const
+{
+  static_assert(is_valid_visitor<VISITOR_T>::value,
+      "VISITOR_T must be a child class of sg::Visitor or"
+      " implement 'bool visit(Node &node, TraversalContext &ctx)'"
+      "!");
+
+  TraversalContext ctx;
+
+  // Open subtrees still waiting for their postChildren() call
+  std::vector<uint32_t> open;
+  open.reserve(32);
+
+  auto closeUntil = [&](uint32_t i) {
+    while (!open.empty()) {
+      const auto top = open.back();
+      if (top + recordList[top].subtreeSize > i)
+        break;
+      open.pop_back();
+      ctx.level = recordList[top].level;
+      visitor.postChildren(*recordList[top].node, ctx);
+    }
+  };
+
+  const uint32_t numRecords = recordList.size();
+  uint32_t i = 0;
+  while (i < numRecords) {
+    closeUntil(i);
+
+    const auto &r = recordList[i];
+    ctx.level = r.level;
+    open.push_back(i);
+
+    if (visitor(*r.node, ctx))
+      i++;
+    else
+      i += r.subtreeSize;
+  }
+
+  closeUntil(numRecords);
+}
+
+} // namespace sg
+} // namespace ospray
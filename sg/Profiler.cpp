@@ -0,0 +1,242 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Profiler.h"
+// std
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+// json
+#include <json.hpp>
+
+namespace ospray {
+namespace sg {
+
+namespace {
+
+struct ThreadBuffer
+{
+  std::mutex mutex;
+  std::vector<Profiler::Event> events;
+  size_t next{0};
+  bool wrapped{false};
+  uint32_t thread{0};
+};
+
+struct BufferList
+{
+  std::mutex mutex;
+  // Kept after their thread exits so its events can still be written
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+BufferList &bufferList()
+{
+  static BufferList list;
+  return list;
+}
+
+thread_local std::shared_ptr<ThreadBuffer> localBuffer;
+thread_local uint32_t localDepth = 0;
+
+ThreadBuffer &threadBuffer()
+{
+  if (!localBuffer) {
+    localBuffer = std::make_shared<ThreadBuffer>();
+    localBuffer->events.resize(Profiler::bufferSize);
+
+    auto &list = bufferList();
+    std::lock_guard<std::mutex> lock(list.mutex);
+    localBuffer->thread = list.buffers.size();
+    list.buffers.push_back(localBuffer);
+  }
+  return *localBuffer;
+}
+
+} // namespace
+
+// Profiler definitions /////////////////////////////////////////////////////
+
+std::atomic<bool> Profiler::enabledFlag{false};
+
+void Profiler::setEnabled(bool enabled)
+{
+  now(); // start the clock
+  enabledFlag = enabled;
+}
+
+uint64_t Profiler::now()
+{
+  using namespace std::chrono;
+  static const auto start = steady_clock::now();
+  return duration_cast<nanoseconds>(steady_clock::now() - start).count();
+}
+
+void Profiler::record(const char *name,
+    std::string detail,
+    uint64_t begin,
+    uint64_t end,
+    uint32_t depth)
+{
+  auto &buffer = threadBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+
+  auto &e = buffer.events[buffer.next];
+  e.name = name;
+  e.detail = std::move(detail);
+  e.begin = begin;
+  e.end = end;
+  e.thread = buffer.thread;
+  e.depth = depth;
+
+  if (++buffer.next == buffer.events.size()) {
+    buffer.next = 0;
+    buffer.wrapped = true;
+  }
+}
+
+std::vector<Profiler::Event> Profiler::events()
+{
+  std::vector<Event> all;
+
+  auto &list = bufferList();
+  std::lock_guard<std::mutex> listLock(list.mutex);
+  for (auto &buffer : list.buffers) {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    const size_t count =
+        buffer->wrapped ? buffer->events.size() : buffer->next;
+    all.insert(
+        all.end(), buffer->events.begin(), buffer->events.begin() + count);
+  }
+
+  std::sort(all.begin(), all.end(), [](const Event &a, const Event &b) {
+    return a.begin < b.begin;
+  });
+
+  return all;
+}
+
+std::vector<Profiler::Summary> Profiler::summary()
+{
+  std::map<std::string, Summary> byName;
+  for (auto &e : events()) {
+    auto &s = byName[e.name];
+    const double ms = (e.end - e.begin) * 1e-6;
+    s.name = e.name;
+    s.count++;
+    s.totalMs += ms;
+    s.maxMs = std::max(s.maxMs, ms);
+  }
+
+  std::vector<Summary> result;
+  for (auto &s : byName)
+    result.push_back(s.second);
+
+  std::sort(result.begin(),
+      result.end(),
+      [](const Summary &a, const Summary &b) { return a.totalMs > b.totalMs; });
+
+  return result;
+}
+
+void Profiler::printSummary(std::ostream &out)
+{
+  auto rows = summary();
+  if (rows.empty())
+    return;
+
+  size_t nameWidth = 4;
+  for (auto &s : rows)
+    nameWidth = std::max(nameWidth, s.name.size());
+
+  const auto flags = out.flags();
+  out << std::left << std::setw(nameWidth) << "name" << std::right
+      << std::setw(10) << "count" << std::setw(14) << "total ms"
+      << std::setw(12) << "avg ms" << std::setw(12) << "max ms" << std::endl;
+
+  out << std::fixed << std::setprecision(3);
+  for (auto &s : rows) {
+    out << std::left << std::setw(nameWidth) << s.name << std::right
+        << std::setw(10) << s.count << std::setw(14) << s.totalMs
+        << std::setw(12) << s.totalMs / s.count << std::setw(12) << s.maxMs
+        << std::endl;
+  }
+  out.flags(flags);
+}
+
+bool Profiler::writeChromeTrace(const std::string &filename)
+{
+  nlohmann::ordered_json traceEvents = nlohmann::ordered_json::array();
+
+  for (auto &e : events()) {
+    nlohmann::ordered_json j = {{"name", e.name},
+        {"cat", "ospStudio"},
+        {"ph", "X"},
+        {"ts", e.begin * 1e-3},
+        {"dur", (e.end - e.begin) * 1e-3},
+        {"pid", 0},
+        {"tid", e.thread}};
+    if (!e.detail.empty())
+      j["args"] = {{"detail", e.detail}};
+    traceEvents.push_back(j);
+  }
+
+  std::ofstream out(filename);
+  if (!out) {
+    std::cerr << "Could not open '" << filename << "' for writing" << std::endl;
+    return false;
+  }
+
+  nlohmann::ordered_json trace = {
+      {"traceEvents", traceEvents}, {"displayTimeUnit", "ms"}};
+  out << trace.dump() << std::endl;
+
+  std::cout << "Saved profile to " << filename << std::endl;
+  return bool(out);
+}
+
+void Profiler::clear()
+{
+  auto &list = bufferList();
+  std::lock_guard<std::mutex> listLock(list.mutex);
+  for (auto &buffer : list.buffers) {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    buffer->next = 0;
+    buffer->wrapped = false;
+  }
+}
+
+// ProfileScope definitions /////////////////////////////////////////////////
+
+ProfileScope::ProfileScope(const char *_name)
+{
+  if (_name && Profiler::enabled()) {
+    name = _name;
+    localDepth++;
+    begin = Profiler::now();
+  }
+}
+
+ProfileScope::ProfileScope(const char *_name, const std::string &_detail)
+{
+  if (_name && Profiler::enabled()) {
+    name = _name;
+    detail = _detail;
+    localDepth++;
+    begin = Profiler::now();
+  }
+}
+
+ProfileScope::~ProfileScope()
+{
+  if (name) {
+    const uint64_t end = Profiler::now();
+    localDepth--;
+    Profiler::record(name, std::move(detail), begin, end, localDepth);
+  }
+}
+
+} // namespace sg
+} // namespace ospray
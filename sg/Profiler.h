@@ -0,0 +1,102 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "Node.h"
+// std
+#include <atomic>
+#include <ostream>
+
+namespace ospray {
+namespace sg {
+
+/////////////////////////////////////////////////////////////////////////////
+// Scoped timers ////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+// Events are recorded by ProfileScope (see SG_PROFILE_SCOPE) into a fixed
+// size ring buffer per thread; once full the oldest events are overwritten.
+// Recording is off until setEnabled(true), a disabled scope costs a single
+// relaxed atomic load.  Nested scopes on a thread form the hierarchy shown
+// by chrome://tracing or Perfetto.
+
+struct OSPSG_INTERFACE Profiler
+{
+  struct Event
+  {
+    // Must outlive the profiler, normally a string literal
+    const char *name{nullptr};
+    // Optional per event information, e.g. the file being imported
+    std::string detail;
+    uint64_t begin{0}; // ns since the profiler was first used
+    uint64_t end{0};
+    uint32_t thread{0};
+    uint32_t depth{0};
+  };
+
+  struct Summary
+  {
+    std::string name;
+    size_t count{0};
+    double totalMs{0.0};
+    double maxMs{0.0};
+  };
+
+  static void setEnabled(bool enabled);
+
+  static inline bool enabled()
+  {
+    return enabledFlag.load(std::memory_order_relaxed);
+  }
+
+  static uint64_t now();
+
+  static void record(const char *name,
+      std::string detail,
+      uint64_t begin,
+      uint64_t end,
+      uint32_t depth);
+
+  // Buffered events of all threads, ordered by begin time
+  static std::vector<Event> events();
+
+  // Totals per event name, longest total first
+  static std::vector<Summary> summary();
+
+  static void printSummary(std::ostream &out);
+
+  // Chrome trace event format, load with chrome://tracing or Perfetto
+  static bool writeChromeTrace(const std::string &filename);
+
+  static void clear();
+
+  // Events kept per thread
+  static const size_t bufferSize = 1 << 16;
+
+ private:
+  static std::atomic<bool> enabledFlag;
+};
+
+struct OSPSG_INTERFACE ProfileScope
+{
+  // A nullptr name makes the scope inactive
+  ProfileScope(const char *name);
+  ProfileScope(const char *name, const std::string &detail);
+  ~ProfileScope();
+
+ private:
+  const char *name{nullptr};
+  std::string detail;
+  uint64_t begin{0};
+};
+
+#define SG_PROFILE_CONCAT_(a, b) a##b
+#define SG_PROFILE_CONCAT(a, b) SG_PROFILE_CONCAT_(a, b)
+
+#define SG_PROFILE_SCOPE(...)                                                  \
+  ospray::sg::ProfileScope SG_PROFILE_CONCAT(profileScope_, __LINE__)(         \
+      __VA_ARGS__)
+
+} // namespace sg
+} // namespace ospray
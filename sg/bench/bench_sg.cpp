@@ -0,0 +1,492 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Micro-benchmarks of the scene graph core, run headless on OSPRay's default
+// CPU device.  Every benchmark is repeated a few times on a freshly built
+// graph, only the part under test is timed.  Results are printed and saved
+// as JSON for regression tracking, e.g.
+//
+//   ospStudio_bench_sg --output results.json --filter commit --repeats 10
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+#include "sg/Data.h"
+#include "sg/Frame.h"
+#include "sg/JSONDefs.h"
+#include "sg/scene/World.h"
+#include "sg/visitors/GetBounds.h"
+#include "version.h"
+using namespace ospray::sg;
+
+using Clock = std::chrono::steady_clock;
+
+// Accumulates the time between start() and stop(), so a benchmark can exclude
+// its setup or time only part of each iteration
+struct Timer
+{
+  inline void start()
+  {
+    begin = Clock::now();
+  }
+
+  inline void stop()
+  {
+    elapsed += Clock::now() - begin;
+  }
+
+  double milliseconds() const
+  {
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+  }
+
+ private:
+  Clock::time_point begin;
+  Clock::duration elapsed{0};
+};
+
+struct BenchmarkRunner
+{
+  int repeats{5};
+  std::string filter;
+  JSON results = JSON::array();
+
+  // body(Timer &) builds what it needs and times the part under test,
+  // items is the number of operations timed per repeat
+  template <typename BODY_T>
+  void run(
+      const std::string &name, const JSON &params, size_t items, BODY_T body);
+};
+
+template <typename BODY_T>
+void BenchmarkRunner::run(
+    const std::string &name, const JSON &params, size_t items, BODY_T body)
+{
+  if (!filter.empty() && name.find(filter) == std::string::npos)
+    return;
+
+  std::vector<double> samples;
+  for (int r = 0; r < repeats; r++) {
+    Timer timer;
+    body(timer);
+    samples.push_back(timer.milliseconds());
+  }
+
+  std::sort(samples.begin(), samples.end());
+  const double mean =
+      std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+  const double median = samples[samples.size() / 2];
+
+  std::string label = name;
+  for (auto &p : params.items())
+    label += " " + p.key() + "=" + p.value().dump();
+  std::cout << std::left << std::setw(44) << label << std::right << std::fixed
+            << std::setprecision(3) << std::setw(12) << median << " ms"
+            << std::setw(12) << median * 1e6 / std::max(items, size_t(1))
+            << " ns/item" << std::endl;
+
+  results.push_back({{"name", name},
+      {"params", params},
+      {"items", items},
+      {"repeats", repeats},
+      {"minMs", samples.front()},
+      {"medianMs", median},
+      {"meanMs", mean},
+      {"maxMs", samples.back()},
+      {"nsPerItem", median * 1e6 / std::max(items, size_t(1))}});
+}
+
+// Synthetic graphs /////////////////////////////////////////////////////////
+
+static std::vector<std::string> makeNames(const std::string &prefix, size_t n)
+{
+  std::vector<std::string> names;
+  names.reserve(n);
+  for (size_t i = 0; i < n; i++)
+    names.push_back(prefix + std::to_string(i));
+  return names;
+}
+
+static NodePtr makeSpheres(const std::string &name, const vec3f &center)
+{
+  auto spheres = createNode(name, "geometry_spheres");
+  spheres->createChildData("sphere.position", std::vector<vec3f>{center});
+  spheres->child("radius") = 0.5f;
+
+  const std::vector<uint32_t> mID = {0};
+  spheres->createChildData("material", mID); // This is a scenegraph parameter
+  spheres->child("material").setSGOnly();
+
+  return spheres;
+}
+
+// One transform with its own geometry per instance
+static std::shared_ptr<World> makeWideWorld(int numInstances)
+{
+  auto world = createNodeAs<World>("world", "world");
+  for (int i = 0; i < numInstances; i++) {
+    auto &xfm = world->createChild("xfm_" + std::to_string(i), "transform");
+    xfm["translation"] = vec3f(i, 0.f, 0.f);
+    xfm.add(makeSpheres("spheres", vec3f(0.f)));
+  }
+  return world;
+}
+
+// A chain of nested transforms with the geometry at the bottom
+static std::shared_ptr<World> makeDeepWorld(int depth)
+{
+  auto world = createNodeAs<World>("world", "world");
+  Node *parent = world.get();
+  for (int i = 0; i < depth; i++) {
+    auto &xfm = parent->createChild("xfm_" + std::to_string(i), "transform");
+    xfm["translation"] = vec3f(1.f, 0.f, 0.f);
+    parent = &xfm;
+  }
+  parent->add(makeSpheres("spheres", vec3f(0.f)));
+  return world;
+}
+
+// Many transforms sharing a single geometry node
+static std::shared_ptr<World> makeInstancedWorld(int numInstances)
+{
+  auto world = createNodeAs<World>("world", "world");
+  auto spheres = makeSpheres("spheres", vec3f(0.f));
+  for (int i = 0; i < numInstances; i++) {
+    auto &xfm = world->createChild("xfm_" + std::to_string(i), "transform");
+    xfm["translation"] = vec3f(i, 0.f, 0.f);
+    xfm.add(spheres);
+  }
+  return world;
+}
+
+// Parameters only, geometry isn't exported to JSON
+static NodePtr makeParameterTree(int numGroups, int numParams)
+{
+  auto root = createNode("root", "Node");
+  for (int g = 0; g < numGroups; g++) {
+    auto &xfm = root->createChild("xfm_" + std::to_string(g), "transform");
+    xfm["translation"] = vec3f(g, 0.f, 0.f);
+    for (int p = 0; p < numParams; p++)
+      xfm.createChild("param_" + std::to_string(p), "float", float(p));
+  }
+  return root;
+}
+
+// Benchmarks ///////////////////////////////////////////////////////////////
+
+static void benchNodes(BenchmarkRunner &bench)
+{
+  const size_t n = 100000;
+  const auto names = makeNames("node_", n);
+
+  bench.run("node_create", {{"count", n}}, n, [&](Timer &t) {
+    std::vector<NodePtr> nodes;
+    nodes.reserve(n);
+    t.start();
+    for (size_t i = 0; i < n; i++)
+      nodes.push_back(createNode(names[i], "int", int(i)));
+    t.stop();
+  });
+
+  bench.run("node_destroy", {{"count", n}}, n, [&](Timer &t) {
+    std::vector<NodePtr> nodes;
+    nodes.reserve(n);
+    for (size_t i = 0; i < n; i++)
+      nodes.push_back(createNode(names[i], "int", int(i)));
+    t.start();
+    nodes.clear();
+    t.stop();
+  });
+}
+
+static void benchChildren(BenchmarkRunner &bench)
+{
+  for (size_t fanout : {10, 100, 1000, 10000}) {
+    const auto names = makeNames("child_", fanout);
+
+    bench.run("node_add", {{"fanout", fanout}}, fanout, [&](Timer &t) {
+      std::vector<NodePtr> children;
+      for (auto &name : names)
+        children.push_back(createNode(name, "int", 0));
+      auto parent = createNode("parent", "Node");
+      t.start();
+      for (auto &child : children)
+        parent->add(child);
+      t.stop();
+    });
+
+    const size_t lookups = 100000;
+    bench.run("node_child", {{"fanout", fanout}}, lookups, [&](Timer &t) {
+      auto parent = createNode("parent", "Node");
+      for (auto &name : names)
+        parent->createChild(name, "int", 0);
+      t.start();
+      for (size_t i = 0; i < lookups; i++)
+        parent->child(names[(i * 7919) % fanout]);
+      t.stop();
+    });
+  }
+}
+
+static void benchSetValue(BenchmarkRunner &bench)
+{
+  const int iterations = 10000;
+
+  for (int depth : {1, 10, 100, 1000}) {
+    bench.run("set_value", {{"depth", depth}}, iterations, [&](Timer &t) {
+      auto root = createNode("root", "Node");
+      Node *parent = root.get();
+      for (int d = 0; d < depth; d++)
+        parent = &parent->createChild("node_" + std::to_string(d), "Node");
+      auto &leaf = parent->createChild("leaf", "int", 0);
+      root->commit();
+
+      // Commit in between so every setValue() marks the whole path dirty
+      for (int i = 1; i <= iterations; i++) {
+        t.start();
+        leaf.setValue(i);
+        t.stop();
+        root->commit();
+      }
+    });
+  }
+}
+
+static void benchScenes(BenchmarkRunner &bench)
+{
+  struct Shape
+  {
+    const char *name;
+    int size;
+    std::shared_ptr<World> (*make)(int);
+  };
+
+  const Shape shapes[] = {{"wide", 10000, makeWideWorld},
+      {"deep", 1000, makeDeepWorld},
+      {"instanced", 10000, makeInstancedWorld}};
+
+  for (auto &shape : shapes) {
+    const JSON params = {{"graph", shape.name}, {"size", shape.size}};
+
+    bench.run("commit", params, shape.size, [&](Timer &t) {
+      auto world = shape.make(shape.size);
+      t.start();
+      world->commit();
+      t.stop();
+    });
+
+    bench.run("render_scene", params, shape.size, [&](Timer &t) {
+      auto world = shape.make(shape.size);
+      world->commit();
+      t.start();
+      world->render();
+      t.stop();
+    });
+
+    bench.run("render_scene_one_dirty", params, 1, [&](Timer &t) {
+      auto world = shape.make(shape.size);
+      world->render();
+      auto &xfm = world->child("xfm_0");
+      xfm["translation"] = vec3f(0.f, 1.f, 0.f);
+      t.start();
+      world->render();
+      t.stop();
+    });
+
+    bench.run("get_bounds", params, shape.size, [&](Timer &t) {
+      auto world = shape.make(shape.size);
+      world->render();
+      auto &xfm = world->child("xfm_0");
+      xfm["translation"] = vec3f(0.f, 1.f, 0.f);
+      GetBounds visitor;
+      t.start();
+      world->traverse(visitor);
+      t.stop();
+    });
+
+    bench.run("get_bounds_cached", params, shape.size, [&](Timer &t) {
+      auto world = shape.make(shape.size);
+      world->render();
+      world->bounds();
+      GetBounds visitor;
+      t.start();
+      world->traverse(visitor);
+      t.stop();
+    });
+  }
+}
+
+static void benchJSON(BenchmarkRunner &bench)
+{
+  const int numGroups = 1000;
+  const int numParams = 10;
+  const JSON params = {{"groups", numGroups}, {"params", numParams}};
+  const size_t items = numGroups * (numParams + 4);
+
+  bench.run("json_serialize", params, items, [&](Timer &t) {
+    auto root = makeParameterTree(numGroups, numParams);
+    t.start();
+    JSON j = *root;
+    auto text = j.dump();
+    t.stop();
+  });
+
+  bench.run("json_deserialize", params, items, [&](Timer &t) {
+    JSON j = *makeParameterTree(numGroups, numParams);
+    auto text = j.dump();
+    t.start();
+    auto root = createNodeFromJSON(JSON::parse(text));
+    t.stop();
+  });
+}
+
+static void benchData(BenchmarkRunner &bench)
+{
+  for (size_t count : {1 << 16, 1 << 20, 1 << 23}) {
+    const std::vector<vec3f> positions(count, vec3f(1.f));
+
+    bench.run("data_copied", {{"count", count}}, count, [&](Timer &t) {
+      auto node = createNode("node", "Node");
+      t.start();
+      node->createChildData("data", positions);
+      t.stop();
+    });
+
+    bench.run("data_shared", {{"count", count}}, count, [&](Timer &t) {
+      auto node = createNode("node", "Node");
+      t.start();
+      node->createChildData("data", positions, true);
+      t.stop();
+    });
+  }
+}
+
+// With nothing modified the per-frame cost of Frame::startNewFrame() must not
+// depend on the graph size.  A modified leaf is only committed along its path
+// to the root, the world is then rebuilt by RenderScene.
+static void benchFrameLoop(BenchmarkRunner &bench)
+{
+  const int numGroups = 1000;
+  const int numFrames = 100;
+
+  for (int numLeaves : {10, 1000}) {
+    const JSON params = {{"groups", numGroups}, {"leaves", numLeaves}};
+
+    auto makeFrame = [&]() {
+      auto frame = createNodeAs<Frame>("frame", "frame");
+      // No rendering, only the scene graph side of the frame loop is measured
+      frame->pauseRendering = true;
+      auto &world = frame->child("world");
+      for (int g = 0; g < numGroups; g++) {
+        auto group = createNode("group_" + std::to_string(g), "Node");
+        for (int l = 0; l < numLeaves; l++)
+          group->createChild("leaf_" + std::to_string(l), "int", l);
+        world.add(group);
+      }
+      return frame;
+    };
+
+    // Settles navMode, which toggles on the first unmodified frame
+    auto settle = [](Frame &frame) {
+      frame.startNewFrame();
+      frame.startNewFrame();
+      frame.startNewFrame();
+    };
+
+    bench.run("frame_initial_commit", params, 1, [&](Timer &t) {
+      auto frame = makeFrame();
+      t.start();
+      frame->startNewFrame();
+      t.stop();
+    });
+
+    bench.run("frame_unmodified", params, numFrames, [&](Timer &t) {
+      auto frame = makeFrame();
+      settle(*frame);
+      t.start();
+      for (int i = 0; i < numFrames; i++)
+        frame->startNewFrame();
+      t.stop();
+    });
+
+    bench.run("frame_one_leaf_dirty", params, numFrames, [&](Timer &t) {
+      auto frame = makeFrame();
+      settle(*frame);
+      auto &leaf = frame->child("world")["group_500"]["leaf_5"];
+      t.start();
+      for (int i = 0; i < numFrames; i++) {
+        leaf.setValue(i);
+        frame->startNewFrame();
+      }
+      t.stop();
+    });
+  }
+}
+
+// Main /////////////////////////////////////////////////////////////////////
+
+static void printHelp()
+{
+  std::cout << "usage: ospStudio_bench_sg [options]\n"
+            << "  --output <file>  save results as JSON\n"
+            << "  --filter <text>  run benchmarks whose name contains text\n"
+            << "  --repeats <n>    runs per benchmark, median is reported\n"
+            << "  --help           this message" << std::endl;
+}
+
+int main(int argc, const char *argv[])
+{
+  // Without --osp:device the default CPU device is used
+  ospInit(&argc, argv);
+
+  BenchmarkRunner bench;
+  std::string output;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--output" && i + 1 < argc)
+      output = argv[++i];
+    else if (arg == "--filter" && i + 1 < argc)
+      bench.filter = argv[++i];
+    else if (arg == "--repeats" && i + 1 < argc)
+      bench.repeats = std::max(1, std::stoi(argv[++i]));
+    else {
+      if (arg != "--help")
+        std::cerr << "unknown argument '" << arg << "'" << std::endl;
+      printHelp();
+      ospShutdown();
+      return arg == "--help" ? 0 : 1;
+    }
+  }
+
+  benchNodes(bench);
+  benchChildren(bench);
+  benchSetValue(bench);
+  benchScenes(bench);
+  benchJSON(bench);
+  benchData(bench);
+  benchFrameLoop(bench);
+
+  int status = 0;
+  if (!output.empty()) {
+    std::ofstream out(output);
+    JSON j = {{"version", OSPRAY_STUDIO_VERSION},
+        {"repeats", bench.repeats},
+        {"results", bench.results}};
+    out << j.dump(2) << std::endl;
+    if (out)
+      std::cout << "Saved results to " << output << std::endl;
+    else {
+      std::cerr << "Could not write '" << output << "'" << std::endl;
+      status = 1;
+    }
+  }
+
+  ospShutdown();
+
+  return status;
+}
@@ -2,6 +2,9 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Camera.h"
+// std
+#include <cmath>
+#include <limits>
 
 namespace ospray {
   namespace sg {
@@ -26,5 +29,53 @@ namespace ospray {
     return NodeType::CAMERA;
   }
 
+  // ViewFrustum definitions //////////////////////////////////////////////////
+
+  ViewFrustum::ViewFrustum(Node &camera)
+  {
+    if (camera.subType() != "camera_perspective"
+        || camera["architectural"].valueAs<bool>()
+        || camera["stereoMode"].valueAs<int>() != OSP_STEREO_NONE)
+      return;
+
+    eye = camera["position"].valueAs<vec3f>();
+    dir = normalize(camera["direction"].valueAs<vec3f>());
+    const vec3f right = normalize(cross(dir, camera["up"].valueAs<vec3f>()));
+    const vec3f up = cross(right, dir);
+    const float fovy = camera["fovy"].valueAs<float>() * ((float)pi / 180.f);
+    tanY = std::tan(0.5f * fovy);
+    const float tanX = tanY * camera["aspect"].valueAs<float>();
+
+    planes[0] = tanX * dir - right;
+    planes[1] = tanX * dir + right;
+    planes[2] = tanY * dir - up;
+    planes[3] = tanY * dir + up;
+    valid = true;
+  }
+
+  bool ViewFrustum::intersects(const box3f &b) const
+  {
+    // Outside if the corner furthest along a plane's normal is behind it
+    for (auto &n : planes) {
+      const vec3f corner(n.x > 0.f ? b.upper.x : b.lower.x,
+          n.y > 0.f ? b.upper.y : b.lower.y,
+          n.z > 0.f ? b.upper.z : b.lower.z);
+      if (dot(n, corner - eye) < 0.f)
+        return false;
+    }
+    return true;
+  }
+
+  float ViewFrustum::projectedPixels(const box3f &b, int frameHeight) const
+  {
+    // The depth underestimates the distance, so the size is overestimated
+    // off axis
+    const float radius = 0.5f * length(b.size());
+    const float depth = dot(b.center() - eye, dir);
+    if (depth <= radius)
+      return std::numeric_limits<float>::infinity();
+    return radius * frameHeight / (depth * tanY);
+  }
+
   }  // namespace sg
 } // namespace ospray
@@ -16,5 +16,29 @@ namespace ospray {
     NodeType type() const override;
   };
 
+  // View frustum of a perspective camera node, for culling.  Other cameras,
+  // and stereo or architectural perspective ones, aren't supported and leave
+  // it invalid.
+  struct OSPSG_INTERFACE ViewFrustum
+  {
+    ViewFrustum(Node &camera);
+
+    // Whether the box is at least partly inside the side planes
+    bool intersects(const box3f &bounds) const;
+
+    // Diameter in pixels of the bounding sphere of the box projected to a
+    // frameHeight pixel high image, infinite if the camera is inside it
+    float projectedPixels(const box3f &bounds, int frameHeight) const;
+
+    bool valid{false};
+
+   private:
+    vec3f eye;
+    vec3f dir;
+    // Inward normals of the side planes, which all pass through the eye
+    vec3f planes[4];
+    float tanY{1.f};
+  };
+
   }  // namespace sg
 } // namespace ospray
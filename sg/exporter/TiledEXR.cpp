@@ -0,0 +1,161 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#if defined(USE_OPENEXR)
+
+#include "TiledImageExporter.h"
+// openexr
+#include "OpenEXR/ImfChannelList.h"
+#include "OpenEXR/ImfTiledOutputFile.h"
+// std
+#include <memory>
+
+namespace ospray {
+namespace sg {
+
+struct TiledEXRExporter : public TiledImageExporter
+{
+  TiledEXRExporter() = default;
+  ~TiledEXRExporter() override = default;
+
+  bool begin(vec2i imageSize, vec2i tileSize, int flags) override;
+  bool writeTile(const ImageTile &tile) override;
+  bool end() override;
+
+ private:
+  std::unique_ptr<Imf::TiledOutputFile> exrFile;
+  vec2i tileSize{0};
+  int flags{0};
+  std::vector<vec4f> floatColor;
+};
+
+OSP_REGISTER_SG_NODE_NAME(TiledEXRExporter, tiled_exporter_exr);
+
+// TiledEXRExporter definitions /////////////////////////////////////////////
+
+bool TiledEXRExporter::begin(vec2i imageSize, vec2i _tileSize, int _flags)
+{
+  namespace IMF = OPENEXR_IMF_NAMESPACE;
+
+  tileSize = _tileSize;
+  flags = _flags;
+
+  Imf::Header exrHeader(imageSize.x, imageSize.y);
+  exrHeader.setTileDescription(
+      Imf::TileDescription(tileSize.x, tileSize.y, Imf::ONE_LEVEL));
+
+  auto &channels = exrHeader.channels();
+  for (auto c : {"R", "G", "B", "A"})
+    channels.insert(c, Imf::Channel(IMF::FLOAT));
+  if (flags & 0b1)
+    for (auto c : {"albedo.R", "albedo.G", "albedo.B"})
+      channels.insert(c, Imf::Channel(IMF::FLOAT));
+  if (flags & 0b10)
+    channels.insert("Z", Imf::Channel(IMF::FLOAT));
+  if (flags & 0b100)
+    for (auto c : {"normal.X", "normal.Y", "normal.Z"})
+      channels.insert(c, Imf::Channel(IMF::FLOAT));
+  if (flags & 0b10000) {
+    channels.insert("objectId", Imf::Channel(IMF::UINT));
+    channels.insert("id", Imf::Channel(IMF::UINT));
+    for (auto c : {"worldPosition.X", "worldPosition.Y", "worldPosition.Z"})
+      channels.insert(c, Imf::Channel(IMF::FLOAT));
+  }
+
+  try {
+    auto file = child("file").valueAs<std::string>();
+    exrFile.reset(new Imf::TiledOutputFile(file.c_str(), exrHeader));
+  } catch (const std::exception &e) {
+    std::cerr << "Could not open tiled EXR: " << e.what() << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TiledEXRExporter::writeTile(const ImageTile &tile)
+{
+  namespace IMF = OPENEXR_IMF_NAMESPACE;
+
+  if (!exrFile)
+    return false;
+
+  const size_t npix = tile.size.x * tile.size.y;
+  const vec4f *color = (const vec4f *)tile.color;
+  if (!tile.floatColor) {
+    floatColor.resize(npix);
+    const vec4uc *c = (const vec4uc *)tile.color;
+    for (size_t i = 0; i < npix; i++)
+      floatColor[i] = vec4f(c[i]) * (1.f / 255.f);
+    color = floatColor.data();
+  }
+
+  // Slices address pixels in image coordinates, offset the base pointers so
+  // the tile origin lands on the start of the buffers
+  auto makeSlice = [&](IMF::PixelType type, const void *buf, int offset,
+                       int ncomp) {
+    const size_t xStride = ncomp * sizeof(float); // uint is the same size
+    const size_t yStride = tile.size.x * xStride;
+    char *base = (char *)((const float *)buf + offset)
+        - tile.origin.x * xStride - tile.origin.y * yStride;
+    return Imf::Slice(type, base, xStride, yStride);
+  };
+
+  Imf::FrameBuffer exrFb;
+  exrFb.insert("R", makeSlice(IMF::FLOAT, color, 0, 4));
+  exrFb.insert("G", makeSlice(IMF::FLOAT, color, 1, 4));
+  exrFb.insert("B", makeSlice(IMF::FLOAT, color, 2, 4));
+  exrFb.insert("A", makeSlice(IMF::FLOAT, color, 3, 4));
+
+  if ((flags & 0b1) && tile.albedo) {
+    exrFb.insert("albedo.R", makeSlice(IMF::FLOAT, tile.albedo, 0, 3));
+    exrFb.insert("albedo.G", makeSlice(IMF::FLOAT, tile.albedo, 1, 3));
+    exrFb.insert("albedo.B", makeSlice(IMF::FLOAT, tile.albedo, 2, 3));
+  }
+  if ((flags & 0b10) && tile.depth)
+    exrFb.insert("Z", makeSlice(IMF::FLOAT, tile.depth, 0, 1));
+  if ((flags & 0b100) && tile.normal) {
+    exrFb.insert("normal.X", makeSlice(IMF::FLOAT, tile.normal, 0, 3));
+    exrFb.insert("normal.Y", makeSlice(IMF::FLOAT, tile.normal, 1, 3));
+    exrFb.insert("normal.Z", makeSlice(IMF::FLOAT, tile.normal, 2, 3));
+  }
+  if ((flags & 0b10000) && tile.geomId && tile.instId && tile.worldPosition) {
+    exrFb.insert("objectId", makeSlice(IMF::UINT, tile.geomId, 0, 1));
+    exrFb.insert("id", makeSlice(IMF::UINT, tile.instId, 0, 1));
+    exrFb.insert(
+        "worldPosition.X", makeSlice(IMF::FLOAT, tile.worldPosition, 0, 3));
+    exrFb.insert(
+        "worldPosition.Y", makeSlice(IMF::FLOAT, tile.worldPosition, 1, 3));
+    exrFb.insert(
+        "worldPosition.Z", makeSlice(IMF::FLOAT, tile.worldPosition, 2, 3));
+  }
+
+  try {
+    exrFile->setFrameBuffer(exrFb);
+    exrFile->writeTile(
+        tile.origin.x / tileSize.x, tile.origin.y / tileSize.y);
+  } catch (const std::exception &e) {
+    std::cerr << "Could not write EXR tile: " << e.what() << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TiledEXRExporter::end()
+{
+  if (!exrFile)
+    return false;
+
+  // Closing the file flushes the remaining tiles
+  exrFile.reset();
+  floatColor.clear();
+  std::cout << "Saved to " << child("file").valueAs<std::string>()
+            << std::endl;
+  return true;
+}
+
+} // namespace sg
+} // namespace ospray
+
+#endif
@@ -0,0 +1,65 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "Exporter.h"
+
+namespace ospray {
+namespace sg {
+
+// One rectangular region of an image, handed to a TiledImageExporter.  All
+// buffers are tightly packed, size.x pixels per row, rows from the top.
+// Optional layers are nullptr when not requested.
+struct ImageTile
+{
+  vec2i origin{0}; // upper left corner within the image
+  vec2i size{0};
+
+  const void *color{nullptr}; // RGBA, 4 floats or 4 bytes per pixel
+  bool floatColor{false};
+
+  const vec3f *albedo{nullptr};
+  const float *depth{nullptr};
+  const vec3f *normal{nullptr};
+
+  const uint32_t *geomId{nullptr};
+  const uint32_t *instId{nullptr};
+  const vec3f *worldPosition{nullptr};
+};
+
+// Exporters which write an image tile by tile, keeping memory bounded by the
+// tile size rather than the image size.  Tiles are written in rows from the
+// top of the image, left to right.
+struct OSPSG_INTERFACE TiledImageExporter : public Exporter
+{
+  TiledImageExporter() = default;
+  ~TiledImageExporter() override = default;
+
+  // 'flags' selects the additional layers, same bits as
+  // FrameBuffer::saveFrame()
+  virtual bool begin(vec2i imageSize, vec2i tileSize, int flags) = 0;
+  virtual bool writeTile(const ImageTile &tile) = 0;
+  virtual bool end() = 0;
+
+  void doExport() override {}
+};
+
+static const std::map<std::string, std::string> tiledExporterMap = {
+    {"png", "tiled_exporter_png"},
+#ifdef STUDIO_OPENEXR
+    {"exr", "tiled_exporter_exr"},
+#endif
+};
+
+inline std::string getTiledExporter(rkcommon::FileName fileName)
+{
+  auto fnd = tiledExporterMap.find(fileName.ext());
+  if (fnd == tiledExporterMap.end())
+    return "";
+  else
+    return fnd->second;
+}
+
+} // namespace sg
+} // namespace ospray
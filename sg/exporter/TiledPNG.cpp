@@ -0,0 +1,204 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "TiledImageExporter.h"
+// std
+#include <array>
+#include <cstring>
+#include <fstream>
+// zlib
+#include <zlib.h>
+
+namespace ospray {
+namespace sg {
+
+// Writes a PNG one row of tiles at a time.  Each row of tiles is deflated as
+// soon as it is complete, so no more than a row of tiles is ever kept in
+// memory.  PNG has no layers, only the color layer is written.
+
+struct TiledPNGExporter : public TiledImageExporter
+{
+  TiledPNGExporter() = default;
+  ~TiledPNGExporter() override;
+
+  bool begin(vec2i imageSize, vec2i tileSize, int flags) override;
+  bool writeTile(const ImageTile &tile) override;
+  bool end() override;
+
+ private:
+  void writeChunk(const char *type, const uint8_t *data, uint32_t size);
+  bool deflateRows(const uint8_t *data, size_t size, int flush);
+
+  std::ofstream out;
+  vec2i imageSize{0};
+  int rowsWritten{0};
+
+  z_stream stream;
+  bool streamOpen{false};
+  std::vector<uint8_t> compressed; // one IDAT chunk worth of output
+
+  // Scanlines of the current row of tiles, each with its filter type byte
+  std::vector<uint8_t> rows;
+};
+
+OSP_REGISTER_SG_NODE_NAME(TiledPNGExporter, tiled_exporter_png);
+
+// Helper functions /////////////////////////////////////////////////////////
+
+static std::array<uint8_t, 4> bigEndian(uint32_t v)
+{
+  return {uint8_t(v >> 24), uint8_t(v >> 16), uint8_t(v >> 8), uint8_t(v)};
+}
+
+// TiledPNGExporter definitions /////////////////////////////////////////////
+
+TiledPNGExporter::~TiledPNGExporter()
+{
+  if (streamOpen)
+    deflateEnd(&stream);
+}
+
+bool TiledPNGExporter::begin(vec2i _imageSize, vec2i tileSize, int flags)
+{
+  imageSize = _imageSize;
+  rowsWritten = 0;
+
+  if (flags & ~0b1000)
+    std::cerr << "Warning: tiled PNG only saves the color layer, use EXR for "
+              << "the other layers" << std::endl;
+
+  out.open(child("file").valueAs<std::string>(), std::ios::binary);
+  if (!out) {
+    std::cerr << "Could not open tiled PNG for writing" << std::endl;
+    return false;
+  }
+
+  if (streamOpen)
+    deflateEnd(&stream);
+  stream = z_stream();
+  streamOpen = deflateInit(&stream, Z_DEFAULT_COMPRESSION) == Z_OK;
+  if (!streamOpen) {
+    std::cerr << "Could not initialize deflate for tiled PNG" << std::endl;
+    return false;
+  }
+  compressed.resize(1 << 20);
+
+  const uint8_t signature[] = {137, 80, 78, 71, 13, 10, 26, 10};
+  out.write((const char *)signature, sizeof(signature));
+
+  // 8 bit RGBA, no interlacing
+  std::array<uint8_t, 13> ihdr = {0, 0, 0, 0, 0, 0, 0, 0, 8, 6, 0, 0, 0};
+  const auto width = bigEndian(imageSize.x);
+  const auto height = bigEndian(imageSize.y);
+  std::copy(width.begin(), width.end(), ihdr.begin());
+  std::copy(height.begin(), height.end(), ihdr.begin() + 4);
+  writeChunk("IHDR", ihdr.data(), ihdr.size());
+
+  rows.assign(size_t(tileSize.y) * (1 + 4 * imageSize.x), 0);
+
+  return bool(out);
+}
+
+bool TiledPNGExporter::writeTile(const ImageTile &tile)
+{
+  if (!out || !streamOpen)
+    return false;
+
+  const size_t stride = 1 + 4 * imageSize.x;
+  const size_t npix = tile.size.x * tile.size.y;
+
+  for (size_t i = 0; i < npix; i++) {
+    const int x = tile.origin.x + i % tile.size.x;
+    const int y = i / tile.size.x;
+    uint8_t *dst = &rows[y * stride + 1 + 4 * x];
+
+    if (tile.floatColor) {
+      const vec4f c = ((const vec4f *)tile.color)[i];
+      auto gamma = [](float x) -> float {
+        return pow(std::max(std::min(x, 1.f), 0.f), 1.f / 2.2f);
+      };
+      dst[0] = uint8_t(255 * gamma(c.x));
+      dst[1] = uint8_t(255 * gamma(c.y));
+      dst[2] = uint8_t(255 * gamma(c.z));
+      dst[3] = uint8_t(255 * std::max(std::min(c.w, 1.f), 0.f));
+    } else {
+      std::memcpy(dst, (const uint8_t *)tile.color + 4 * i, 4);
+    }
+  }
+
+  // Last tile of the row, compress it and stream it out
+  if (tile.origin.x + tile.size.x == imageSize.x) {
+    if (!deflateRows(rows.data(), tile.size.y * stride, Z_NO_FLUSH))
+      return false;
+    rowsWritten += tile.size.y;
+  }
+
+  return bool(out);
+}
+
+bool TiledPNGExporter::end()
+{
+  if (!out || !streamOpen)
+    return false;
+
+  if (rowsWritten != imageSize.y)
+    std::cerr << "Warning: tiled PNG is missing rows" << std::endl;
+
+  const bool finished = deflateRows(nullptr, 0, Z_FINISH);
+  deflateEnd(&stream);
+  streamOpen = false;
+
+  writeChunk("IEND", nullptr, 0);
+
+  out.close();
+  rows.clear();
+  compressed.clear();
+
+  if (!finished || !out) {
+    std::cerr << "Could not write tiled PNG" << std::endl;
+    return false;
+  }
+
+  std::cout << "Saved to " << child("file").valueAs<std::string>()
+            << std::endl;
+  return true;
+}
+
+void TiledPNGExporter::writeChunk(
+    const char *type, const uint8_t *data, uint32_t size)
+{
+  out.write((const char *)bigEndian(size).data(), 4);
+  out.write(type, 4);
+  if (size)
+    out.write((const char *)data, size);
+
+  uLong crc = crc32(0, (const Bytef *)type, 4);
+  if (size)
+    crc = crc32(crc, data, size);
+  out.write((const char *)bigEndian(crc).data(), 4);
+}
+
+bool TiledPNGExporter::deflateRows(const uint8_t *data, size_t size, int flush)
+{
+  stream.next_in = const_cast<Bytef *>(data);
+  stream.avail_in = size;
+
+  // Every time the output buffer fills up it becomes one IDAT chunk
+  int result = Z_OK;
+  do {
+    stream.next_out = compressed.data();
+    stream.avail_out = compressed.size();
+    result = deflate(&stream, flush);
+    if (result == Z_STREAM_ERROR)
+      return false;
+
+    const uint32_t produced = compressed.size() - stream.avail_out;
+    if (produced)
+      writeChunk("IDAT", compressed.data(), produced);
+  } while (stream.avail_out == 0);
+
+  return (flush != Z_FINISH || result == Z_STREAM_END) && bool(out);
+}
+
+} // namespace sg
+} // namespace ospray
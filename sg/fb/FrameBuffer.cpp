@@ -3,14 +3,25 @@
 
 #include "FrameBuffer.h"
 #include "../exporter/ImageExporter.h"
+#include "../Profiler.h"
 
 #include "sg/camera/Camera.h"
 #include "sg/renderer/Renderer.h"
 #include "sg/scene/World.h"
+// std
+#include <algorithm>
 
 namespace ospray {
 namespace sg {
 
+const std::vector<std::string> FrameBuffer::imageOpParams = {"exposure",
+    "contrast",
+    "shoulder",
+    "midIn",
+    "midOut",
+    "hdrMax",
+    "acesColor"};
+
 FrameBuffer::FrameBuffer()
 {
   createChild("floatFormat",
@@ -50,6 +61,7 @@ FrameBuffer::FrameBuffer()
   child("midOut").setMinMax(0.f, 1.f);
   child("hdrMax").setMinMax(0.f, 100.f);
 
+  updateFormat();
   updateHandle();
 }
 
@@ -67,6 +79,7 @@ NodeType FrameBuffer::type() const
 
 const void *FrameBuffer::map(OSPFrameBufferChannel channel)
 {
+  SG_PROFILE_SCOPE("FrameBuffer::map");
   return handle().map(channel);
 }
 
@@ -85,12 +98,68 @@ float FrameBuffer::variance()
   return handle().variance();
 }
 
+size_t FrameBuffer::memoryUsage()
+{
+  const auto size = child("size").valueAs<vec2i>();
+  const size_t numPixels = size_t(size.x) * size.y;
+
+  size_t pixelBytes = isFloatFormat() ? sizeof(vec4f) : sizeof(uint32_t);
+  if (channels & OSP_FB_DEPTH)
+    pixelBytes += sizeof(float);
+  if (channels & OSP_FB_ACCUM)
+    pixelBytes += sizeof(vec4f);
+  if (channels & OSP_FB_VARIANCE)
+    pixelBytes += sizeof(vec4f);
+  if (channels & OSP_FB_NORMAL)
+    pixelBytes += sizeof(vec3f);
+  if (channels & OSP_FB_ALBEDO)
+    pixelBytes += sizeof(vec3f);
+
+  if (instData)
+    pixelBytes += sizeof(uint32_t);
+  if (geomData)
+    pixelBytes += sizeof(uint32_t);
+  if (worldPosData)
+    pixelBytes += 3 * sizeof(float);
+
+  return numPixels * pixelBytes;
+}
+
+bool FrameBuffer::onlyImageOpsModified()
+{
+  if (!isModified() || lastModified() > lastCommitted())
+    return false;
+
+  for (auto &c : children()) {
+    if (c.second->isModified()
+        && std::find(imageOpParams.begin(), imageOpParams.end(), c.first)
+            == imageOpParams.end())
+      return false;
+  }
+
+  return true;
+}
+
 void FrameBuffer::postCommit()
 {
-  updateHandle();
+  updateFormat();
+
+  // Size, format and channel changes need a new framebuffer.  Anything else
+  // is an image operation parameter, update those in place and keep the
+  // accumulated samples.
+  auto size = child("size").valueAs<vec2i>();
+  auto colorFormatStr = child("colorFormat").valueAs<std::string>();
+  if (size != allocatedSize || colorFormatStr != allocatedFormat
+      || channels != allocatedChannels) {
+    updateHandle();
+  } else if (hasToneMapper) {
+    updateToneMapperParams();
+    // The framebuffer picks up image operation changes on commit
+    handle().commit();
+  }
 }
 
-void FrameBuffer::updateHandle()
+void FrameBuffer::updateFormat()
 {
   // Default minimal format
   channels = OSP_FB_COLOR | OSP_FB_ACCUM | OSP_FB_VARIANCE;
@@ -108,7 +177,10 @@ void FrameBuffer::updateHandle()
     auto sRGB = child("sRGB").valueAs<bool>();
     child("colorFormat") = std::string(sRGB ? "sRGB" : "RGBA8");
   }
+}
 
+void FrameBuffer::updateHandle()
+{
   auto size = child("size").valueAs<vec2i>();
   auto colorFormatStr = child("colorFormat").valueAs<std::string>();
 
@@ -124,6 +196,10 @@ void FrameBuffer::updateHandle()
 
   setHandle(fb);
 
+  allocatedSize = size;
+  allocatedFormat = colorFormatStr;
+  allocatedChannels = channels;
+
   // Recreating the framebuffer will change the imageOps.  Refresh them.
   if (hasDenoiser || hasToneMapper) {
     updateImageOps = true;
@@ -161,26 +237,16 @@ void FrameBuffer::updateImageOperations()
 
   std::vector<cpp::ImageOperation> ops = {};
   if (hasToneMapper) {
-    auto iop = cpp::ImageOperation("tonemapper");
-    float exposure = child("exposure").valueAs<float>();
-    iop.setParam("exposure", OSP_FLOAT, &exposure);
-    float contrast = child("contrast").valueAs<float>();
-    iop.setParam("contrast", OSP_FLOAT, &contrast);
-    float shoulder = child("shoulder").valueAs<float>();
-    iop.setParam("shoulder", OSP_FLOAT, &shoulder);
-    float midIn = child("midIn").valueAs<float>();
-    iop.setParam("midIn", OSP_FLOAT, &midIn);
-    float midOut = child("midOut").valueAs<float>();
-    iop.setParam("midOut", OSP_FLOAT, &midOut);
-    float hdrMax = child("hdrMax").valueAs<float>();
-    iop.setParam("hdrMax", OSP_FLOAT, &hdrMax);
-    bool acesColor = child("acesColor").valueAs<bool>();
-    iop.setParam("acesColor", OSP_BOOL, &acesColor);
-    iop.commit();
-    ops.push_back(iop);
+    if (!toneMapper.handle())
+      toneMapper = cpp::ImageOperation("tonemapper");
+    updateToneMapperParams();
+    ops.push_back(toneMapper);
+  }
+  if (hasDenoiser) {
+    if (!denoiser.handle())
+      denoiser = cpp::ImageOperation("denoiser");
+    ops.push_back(denoiser);
   }
-  if (hasDenoiser)
-    ops.push_back(cpp::ImageOperation("denoiser"));
 
   if (isFloatFormat() && (hasDenoiser || hasToneMapper))
     handle().setParam("imageOperation", cpp::CopiedData(ops));
@@ -189,8 +255,31 @@ void FrameBuffer::updateImageOperations()
   handle().commit();
 }
 
+void FrameBuffer::updateToneMapperParams()
+{
+  if (!toneMapper.handle())
+    return;
+
+  float exposure = child("exposure").valueAs<float>();
+  toneMapper.setParam("exposure", OSP_FLOAT, &exposure);
+  float contrast = child("contrast").valueAs<float>();
+  toneMapper.setParam("contrast", OSP_FLOAT, &contrast);
+  float shoulder = child("shoulder").valueAs<float>();
+  toneMapper.setParam("shoulder", OSP_FLOAT, &shoulder);
+  float midIn = child("midIn").valueAs<float>();
+  toneMapper.setParam("midIn", OSP_FLOAT, &midIn);
+  float midOut = child("midOut").valueAs<float>();
+  toneMapper.setParam("midOut", OSP_FLOAT, &midOut);
+  float hdrMax = child("hdrMax").valueAs<float>();
+  toneMapper.setParam("hdrMax", OSP_FLOAT, &hdrMax);
+  bool acesColor = child("acesColor").valueAs<bool>();
+  toneMapper.setParam("acesColor", OSP_BOOL, &acesColor);
+  toneMapper.commit();
+}
+
 void FrameBuffer::saveFrame(std::string filename, int flags)
 {
+  SG_PROFILE_SCOPE("FrameBuffer::saveFrame", filename);
   auto exporter = getExporter(FileName(filename));
   if (exporter == "") {
     std::cout << "No exporter found for type " << FileName(filename).ext()
@@ -266,6 +355,21 @@ void FrameBuffer::saveFrame(std::string filename, int flags)
 }
 
 void FrameBuffer::pickFrame(std::string filename)
+{
+  resetPickIds();
+  pickIds();
+  savePickIds(filename);
+}
+
+void FrameBuffer::resetPickIds()
+{
+  gUnique.clear();
+  gUnique.insert(std::make_pair("", 0));
+  iUnique.clear();
+  iUnique.insert(std::make_pair("", 0));
+}
+
+void FrameBuffer::pickIds()
 {
   auto &frame = parents().front();
   auto &world = frame->childAs<sg::World>("world").handle();
@@ -282,12 +386,6 @@ void FrameBuffer::pickFrame(std::string filename)
   if (!instData || !geomData || !worldPosData)
     return;
 
-  std::map<std::string, int> gUnique;
-  gUnique.insert(std::make_pair("", 0));
-
-  std::map<std::string, int> iUnique;
-  iUnique.insert(std::make_pair("", 0));
-
   size_t idx = 0;
   for (auto j = 0; j < size.y; ++j) {
     for (auto i = 0; i < size.x; ++i, ++idx) {
@@ -336,7 +434,10 @@ void FrameBuffer::pickFrame(std::string filename)
       worldPosData[idx * 3 + 2] = worldPosition[2];
     }
   }
+}
 
+void FrameBuffer::savePickIds(std::string filename)
+{
   auto geomStream =
       filename.substr(0, filename.find_last_of(".")) + ".objectId.json";
   auto instStream = filename.substr(0, filename.find_last_of(".")) + ".id.json";
@@ -19,6 +19,10 @@ namespace ospray {
     const void *map(OSPFrameBufferChannel = OSP_FB_COLOR);
     void unmap(const void *mem);
     float variance();
+
+    // Estimated size of the OSPRay channels and the pick buffers, in bytes
+    size_t memoryUsage();
+
     uint32_t *instData{nullptr};
     uint32_t *geomData{nullptr};
     float *worldPosData{nullptr};
@@ -30,9 +34,21 @@ namespace ospray {
     void updateDenoiser(bool enabled);
     void updateToneMapper(bool enabled);
     void updateImageOperations();
+
+    // True when the only pending changes are image operation parameters
+    // (e.g. tone mapper exposure), which are applied to the existing
+    // framebuffer without reallocating it or clearing accumulation
+    bool onlyImageOpsModified();
+
     void saveFrame(std::string filename, int flags);
     void pickFrame(std::string filename);
 
+    // Pieces of pickFrame() for rendering in several passes (e.g. tiles),
+    // ids stay consistent across pickIds() calls until resetPickIds()
+    void resetPickIds();
+    void pickIds();
+    void savePickIds(std::string filename);
+
     inline bool isFloatFormat()
     {
       return (child("colorFormat").valueAs<std::string>() == "float");
@@ -56,13 +72,32 @@ namespace ospray {
    private:
     void postCommit() override;
 
+    void updateFormat();
     void updateHandle();
+    void updateToneMapperParams();
     uint32_t channels{OSP_FB_COLOR};  // OSPFrameBufferChannel
 
+    // What the current handle was created with, to tell when a commit needs
+    // a new framebuffer
+    vec2i allocatedSize{0};
+    std::string allocatedFormat;
+    uint32_t allocatedChannels{0};
+
     bool hasDenoiser{false};
     bool hasToneMapper{false};
     bool updateImageOps{false};
 
+    // Kept across updates so parameter changes don't recreate them
+    cpp::ImageOperation toneMapper;
+    cpp::ImageOperation denoiser;
+
+    // Children which only affect the image operations
+    static const std::vector<std::string> imageOpParams;
+
+    // Unique geometry and instance ids handed out by pickIds()
+    std::map<std::string, int> gUnique;
+    std::map<std::string, int> iUnique;
+
     std::map<std::string, OSPFrameBufferFormat> colorFormats{
         {"sRGB", OSP_FB_SRGBA},
         {"RGBA8", OSP_FB_RGBA8},
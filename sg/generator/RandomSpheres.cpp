@@ -33,11 +33,12 @@ namespace ospray {
     std::uniform_real_distribution<float> dist(-1.f + radius, 1.f - radius);
 
     std::vector<vec3f> centers;
+    centers.reserve(numSpheres);
 
     for (int i = 0; i < numSpheres; ++i)
       centers.push_back(vec3f(dist(rng), dist(rng), dist(rng)));
 
-    spheres.createChildData("sphere.position", centers);
+    spheres.createChildData("sphere.position", std::move(centers));
     spheres.child("radius") = radius;
 
     const std::vector<uint32_t> mID = {0};
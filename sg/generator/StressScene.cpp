@@ -0,0 +1,408 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Generator.h"
+// rkcommon
+#include "rkcommon/tasking/parallel_for.h"
+
+namespace ospray {
+namespace sg {
+
+// Procedural scene for scaling tests of BVH builds, memory use and render
+// throughput.  Primitive counts are per instance, the content is placed in
+// the [-1, 1] cube and instanced on a grid.  Large counts are split into
+// several geometries of primitivesPerGeometry each.
+//
+// Random numbers come from counter based streams: every value is a function
+// of the seed and the primitive's index only, so the scene is the same for
+// any number of threads.
+
+struct StressScene : public Generator
+{
+  StressScene();
+  ~StressScene() override = default;
+
+  void generateData() override;
+
+ private:
+  void generateSpheres(Node &content, size_t count);
+  void generateBoxes(Node &content, size_t count);
+  void generateTriangles(Node &content, size_t count);
+  void generateCurves(Node &content, size_t count);
+  void generateVolumes(Node &content, size_t count);
+  void createMaterials(size_t count);
+
+  template <typename FILL_T>
+  void forEachGeometry(Node &content,
+      const std::string &name,
+      const std::string &subType,
+      uint64_t kind,
+      size_t count,
+      FILL_T fill);
+
+  void setMaterials(Node &geometry, uint64_t kind, size_t first, size_t count);
+
+  uint64_t seed{0};
+  size_t primitivesPerGeometry{0};
+  size_t numMaterials{0};
+  std::vector<uint32_t> materialIDs; // registry index of each material
+  float primitiveSize{0.f};
+};
+
+OSP_REGISTER_SG_NODE_NAME(StressScene, generator_stress_scene);
+
+// Helper functions /////////////////////////////////////////////////////////
+
+namespace {
+
+// Random streams, one per (seed, kind, index), SplitMix64 over a counter
+struct RandomStream
+{
+  RandomStream(uint64_t seed, uint64_t kind, uint64_t index)
+      : key(mix(mix(seed + kind * 0x9e3779b97f4a7c15ull) + index))
+  {}
+
+  inline uint64_t next()
+  {
+    return mix(key + ++counter * 0x9e3779b97f4a7c15ull);
+  }
+
+  // [0, 1)
+  inline float uniform()
+  {
+    return (next() >> 40) * (1.f / (1 << 24));
+  }
+
+  inline float uniform(float lower, float upper)
+  {
+    return lower + (upper - lower) * uniform();
+  }
+
+  inline vec3f uniform3(float lower, float upper)
+  {
+    // Sequenced, argument evaluation order is unspecified
+    const float x = uniform(lower, upper);
+    const float y = uniform(lower, upper);
+    const float z = uniform(lower, upper);
+    return vec3f(x, y, z);
+  }
+
+ private:
+  static inline uint64_t mix(uint64_t z)
+  {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t key;
+  uint64_t counter{0};
+};
+
+enum StreamKind : uint64_t
+{
+  SPHERES = 1,
+  BOXES,
+  TRIANGLES,
+  CURVES,
+  VOLUMES,
+  MATERIALS,
+  // + the geometry's kind
+  MATERIAL_IDS = 16
+};
+
+} // namespace
+
+// Fills items [0, count) in parallel blocks
+template <typename FUNC_T>
+static void parallelItems(size_t count, FUNC_T func)
+{
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (count + blockSize - 1) / blockSize;
+  tasking::parallel_for(numBlocks, [&](size_t block) {
+    const size_t end = std::min(count, (block + 1) * blockSize);
+    for (size_t i = block * blockSize; i < end; i++)
+      func(i);
+  });
+}
+
+// StressScene definitions //////////////////////////////////////////////////
+
+StressScene::StressScene()
+{
+  auto &parameters = child("parameters");
+
+  parameters.createChild("spheres", "int", "spheres per instance", 100000);
+  parameters.createChild("boxes", "int", "boxes per instance", 10000);
+  parameters.createChild(
+      "triangles", "int", "triangles per instance", 100000);
+  parameters.createChild(
+      "curves", "int", "linear curve segments per instance", 10000);
+  parameters.createChild("volumes", "int", "volumes per instance", 0);
+  parameters.createChild(
+      "volumeSize", "int", "voxels along each volume axis", 32);
+  parameters.createChild(
+      "instances", "int", "copies of the content, on a grid", 1);
+  parameters.createChild("materials", "int", "randomly assigned", 8);
+  parameters.createChild("primitivesPerGeometry",
+      "int",
+      "larger counts are split into several geometries",
+      1 << 20);
+  parameters.createChild("seed", "int", 0);
+
+  for (auto name : {"spheres",
+           "boxes",
+           "triangles",
+           "curves",
+           "volumes",
+           "instances",
+           "materials"})
+    parameters[name].setMinMax(0, 1 << 30);
+  parameters["volumeSize"].setMinMax(2, 1024);
+  parameters["primitivesPerGeometry"].setMinMax(1, 1 << 30);
+}
+
+void StressScene::generateData()
+{
+  remove("content");
+  remove("instances");
+
+  auto &parameters = child("parameters");
+  auto count = [&](const char *name) {
+    return size_t(std::max(0, parameters[name].valueAs<int>()));
+  };
+
+  seed = uint64_t(parameters["seed"].valueAs<int>());
+  primitivesPerGeometry = std::max(size_t(1), count("primitivesPerGeometry"));
+
+  const size_t numSpheres = count("spheres");
+  const size_t numBoxes = count("boxes");
+  const size_t numTriangles = count("triangles");
+  const size_t numCurves = count("curves");
+  const size_t numVolumes = count("volumes");
+  const size_t numInstances = std::max(size_t(1), count("instances"));
+
+  // Keep the overall density roughly constant
+  const size_t total = numSpheres + numBoxes + numTriangles + numCurves;
+  primitiveSize = 0.5f / std::max(1.f, std::cbrt(float(total)));
+
+  createMaterials(std::max(size_t(1), count("materials")));
+
+  auto content = createNode("content", "transform");
+  generateSpheres(*content, numSpheres);
+  generateBoxes(*content, numBoxes);
+  generateTriangles(*content, numTriangles);
+  generateCurves(*content, numCurves);
+  generateVolumes(*content, numVolumes);
+
+  if (numInstances == 1) {
+    add(content);
+    return;
+  }
+
+  // Instances share the content
+  auto &instances = createChild("instances");
+  const int side = int(std::ceil(std::cbrt(double(numInstances))));
+  for (size_t i = 0; i < numInstances; i++) {
+    const vec3i cell(i % side, (i / side) % side, i / (side * side));
+    auto &xfm = instances.createChild(
+        "instance_" + std::to_string(i), "transform");
+    xfm["translation"] = 2.5f * vec3f(cell);
+    xfm.add(content);
+  }
+}
+
+void StressScene::createMaterials(size_t count)
+{
+  numMaterials = count;
+  materialIDs.assign(1, 0);
+
+  // Without a registry everything uses the default material
+  if (!materialRegistry) {
+    numMaterials = 1;
+    return;
+  }
+
+  std::vector<NodePtr> materials(count);
+  for (size_t i = 0; i < count; i++) {
+    RandomStream rng(seed, MATERIALS, i);
+    materials[i] = createNode("stress_" + std::to_string(i), "obj");
+    materials[i]->createChild("kd", "rgb", rng.uniform3(0.1f, 0.9f));
+  }
+
+  // When regenerating, the previous stress_* materials are replaced in place
+  // and keep their index, the registry reports where each one ended up
+  materialIDs = materialRegistry->addMaterials(materials);
+}
+
+void StressScene::setMaterials(
+    Node &geometry, uint64_t kind, size_t first, size_t count)
+{
+  if (numMaterials == 1) {
+    const std::vector<uint32_t> mID = {materialIDs[0]};
+    geometry.createChildData("material", mID);
+  } else {
+    std::vector<uint32_t> mIDs(count);
+    parallelItems(count, [&](size_t i) {
+      RandomStream rng(seed, MATERIAL_IDS + kind, first + i);
+      mIDs[i] = materialIDs[rng.next() % numMaterials];
+    });
+    geometry.createChildData("material", std::move(mIDs));
+  }
+  geometry.child("material").setSGOnly();
+}
+
+template <typename FILL_T>
+void StressScene::forEachGeometry(Node &content,
+    const std::string &name,
+    const std::string &subType,
+    uint64_t kind,
+    size_t count,
+    FILL_T fill)
+{
+  const size_t numGeometries =
+      (count + primitivesPerGeometry - 1) / primitivesPerGeometry;
+
+  for (size_t g = 0; g < numGeometries; g++) {
+    const size_t first = g * primitivesPerGeometry;
+    const size_t n = std::min(primitivesPerGeometry, count - first);
+
+    auto &geometry =
+        content.createChild(name + "_" + std::to_string(g), subType);
+    fill(geometry, first, n);
+    setMaterials(geometry, kind, first, n);
+  }
+}
+
+void StressScene::generateSpheres(Node &content, size_t count)
+{
+  forEachGeometry(content,
+      "spheres",
+      "geometry_spheres",
+      SPHERES,
+      count,
+      [&](Node &geometry, size_t first, size_t n) {
+        std::vector<vec3f> centers(n);
+        parallelItems(n, [&](size_t i) {
+          RandomStream rng(seed, SPHERES, first + i);
+          centers[i] = rng.uniform3(-1.f, 1.f);
+        });
+        geometry.createChildData("sphere.position", std::move(centers));
+        geometry["radius"] = primitiveSize;
+      });
+}
+
+void StressScene::generateBoxes(Node &content, size_t count)
+{
+  forEachGeometry(content,
+      "boxes",
+      "geometry_boxes",
+      BOXES,
+      count,
+      [&](Node &geometry, size_t first, size_t n) {
+        std::vector<box3f> boxes(n);
+        parallelItems(n, [&](size_t i) {
+          RandomStream rng(seed, BOXES, first + i);
+          const vec3f center = rng.uniform3(-1.f, 1.f);
+          const vec3f halfSize = rng.uniform3(0.5f, 1.f) * primitiveSize;
+          boxes[i] = box3f(center - halfSize, center + halfSize);
+        });
+        geometry.createChildData("box", std::move(boxes));
+      });
+}
+
+void StressScene::generateTriangles(Node &content, size_t count)
+{
+  forEachGeometry(content,
+      "triangles",
+      "geometry_triangles",
+      TRIANGLES,
+      count,
+      [&](Node &geometry, size_t first, size_t n) {
+        std::vector<vec3f> vertices(3 * n);
+        std::vector<vec3ui> indices(n);
+        parallelItems(n, [&](size_t i) {
+          RandomStream rng(seed, TRIANGLES, first + i);
+          const vec3f center = rng.uniform3(-1.f, 1.f);
+          for (int v = 0; v < 3; v++)
+            vertices[3 * i + v] =
+                center + 2.f * primitiveSize * rng.uniform3(-1.f, 1.f);
+          indices[i] = vec3ui(3 * i, 3 * i + 1, 3 * i + 2);
+        });
+        geometry.createChildData("vertex.position", std::move(vertices));
+        geometry.createChildData("index", std::move(indices));
+      });
+}
+
+void StressScene::generateCurves(Node &content, size_t count)
+{
+  forEachGeometry(content,
+      "curves",
+      "geometry_curves",
+      CURVES,
+      count,
+      [&](Node &geometry, size_t first, size_t n) {
+        std::vector<vec4f> vertices(2 * n);
+        std::vector<uint32_t> indices(n);
+        parallelItems(n, [&](size_t i) {
+          RandomStream rng(seed, CURVES, first + i);
+          const vec3f start = rng.uniform3(-1.f, 1.f);
+          const vec3f end =
+              start + 4.f * primitiveSize * rng.uniform3(-1.f, 1.f);
+          const float radius = 0.25f * primitiveSize;
+          vertices[2 * i] = vec4f(start, radius);
+          vertices[2 * i + 1] = vec4f(end, radius);
+          indices[i] = 2 * i;
+        });
+        geometry.remove("radius");
+        geometry.createChildData(
+            "vertex.position_radius", std::move(vertices));
+        geometry.createChildData("index", std::move(indices));
+        geometry.createChild("type", "uchar", (unsigned char)OSP_ROUND);
+        geometry.createChild("basis", "uchar", (unsigned char)OSP_LINEAR);
+      });
+}
+
+void StressScene::generateVolumes(Node &content, size_t count)
+{
+  if (!count)
+    return;
+
+  const int size = child("parameters")["volumeSize"].valueAs<int>();
+  const vec3i dimensions(size);
+  const float extent = std::max(0.05f, 1.f / std::cbrt(float(count)));
+
+  auto &tf = content.createChild("transferFunction", "transfer_function_jet");
+
+  for (size_t v = 0; v < count; v++) {
+    RandomStream rng(seed, VOLUMES, v);
+    const vec3f origin = rng.uniform3(-1.f, 1.f - extent);
+    const vec3f frequency = rng.uniform3(2.f, 8.f);
+    const vec3f phase = rng.uniform3(0.f, 6.28f);
+
+    // Smooth and deterministic, no random numbers per voxel needed
+    std::vector<float> voxels(dimensions.long_product());
+    tasking::parallel_for(size, [&](int z) {
+      for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+          const vec3f p = vec3f(x, y, z) / float(size - 1);
+          const size_t index = (size_t(z) * size + y) * size + x;
+          voxels[index] = std::sin(frequency.x * p.x + phase.x)
+              * std::sin(frequency.y * p.y + phase.y)
+              * std::sin(frequency.z * p.z + phase.z);
+        }
+      }
+    });
+
+    auto &volume =
+        tf.createChild("volume_" + std::to_string(v), "structuredRegular");
+    volume.createChild("voxelType") = int(OSP_FLOAT);
+    volume.createChild("gridOrigin") = origin;
+    volume.createChild("gridSpacing") = vec3f(extent / (size - 1));
+    volume.createChild("dimensions") = dimensions;
+    volume.createChildData("data", std::move(voxels), vec3ul(dimensions));
+  }
+}
+
+} // namespace sg
+} // namespace ospray
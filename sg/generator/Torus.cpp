@@ -54,7 +54,8 @@ namespace ospray {
     volume->createChild(
         "gridSpacing", "vec3f", vec3f(1.f / size, 1.f / size, 1.f / size));
     volume->createChild("dimensions", "vec3i", vec3i(size));
-    volume->createChildData("data", vec3i(size), 0, volumetricData.data());
+    volume->createChildData(
+        "data", std::move(volumetricData), vec3ul(size, size, size));
     tf.add(volume);
   }
 
@@ -96,7 +96,7 @@ void WaveletVolume::generateData()
   volume.createChild("gridOrigin") = gridOrigin;
   volume.createChild("gridSpacing") = gridSpacing;
   volume.createChild("dimensions") = dimensions;
-  volume.createChildData("data", dimensions, 0, voxels.data());
+  volume.createChildData("data", std::move(voxels), vec3ul(dimensions));
 }
 
 } // namespace sg
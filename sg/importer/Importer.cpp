@@ -2,9 +2,12 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Importer.h"
+#include "sg/scene/Transform.h"
 #include "sg/visitors/PrintNodes.h"
+#include "../Profiler.h"
 
 #include "../JSONDefs.h"
+#include "../NodeIndex.h"
 
 namespace ospray {
 namespace sg {
@@ -28,11 +31,156 @@ NodeType Importer::type() const
 void Importer::importScene() {
 }
 
+void Importer::deferImport(const box3f &bounds)
+{
+  deferred = true;
+  deferredBounds = bounds;
+
+  auto rootNode = createNode(rootXfmName(), "transform");
+  if (!bounds.empty()) {
+    auto &standIn = rootNode->createChild(standInName(), "geometry_boxes");
+    standIn.createChildData("box", bounds);
+  }
+  add(rootNode);
+
+  deferredImports.push_back(
+      std::static_pointer_cast<Importer>(shared_from_this()));
+}
+
+void Importer::importDeferred()
+{
+  if (!deferred)
+    return;
+  deferred = false;
+  importedBounds = deferredBounds;
+
+  std::cout << "Importing: " << fileName << std::endl;
+  SG_PROFILE_SCOPE("importScene", fileName.str());
+
+  // Keep the stand-in's root transform, it may have been placed meanwhile,
+  // and move the imported model into it
+  auto rootNode = child(rootXfmName()).shared_from_this();
+
+  // Instances made by getImporter() share the stand-in
+  std::vector<Node *> instances;
+  if (rootNode->hasChild(standInName())) {
+    auto &standIn = rootNode->child(standInName());
+    for (auto *parent : standIn.parents()) {
+      if (parent != rootNode.get())
+        instances.push_back(parent);
+    }
+    for (auto *instance : instances)
+      instance->remove(standIn);
+    rootNode->remove(standInName());
+  }
+
+  importScene();
+
+  std::vector<NodePtr> model;
+  auto &imported = child(rootXfmName());
+  if (&imported != rootNode.get()) {
+    for (auto &c : imported.children()) {
+      if (!rootNode->hasChild(c.first))
+        model.push_back(c.second);
+    }
+    for (auto &c : model) {
+      imported.remove(*c);
+      rootNode->add(c);
+    }
+    add(rootNode);
+  } else {
+    for (auto &c : rootNode->children())
+      model.push_back(c.second);
+  }
+
+  // Instances share the model, as instances of an imported model do
+  for (auto *instance : instances) {
+    for (auto &c : model)
+      instance->add(c);
+  }
+}
+
+// World transforms of every path from the top of the graph down to a node.
+// Unlike Transform::accumulatedXfm, which only holds the path RenderScene
+// visited last, this covers each placement of a shared node.
+static void placements(
+    Node &node, const affine3f &below, std::vector<affine3f> &xfms)
+{
+  const affine3f xfm = node.type() == NodeType::TRANSFORM
+      ? node.nodeAs<Transform>()->localXfm() * below
+      : below;
+
+  if (!node.hasParents()) {
+    xfms.push_back(xfm);
+    return;
+  }
+
+  for (auto *parent : node.parents())
+    placements(*parent, xfm, xfms);
+}
+
+bool Importer::standInVisible(const ViewFrustum &view)
+{
+  if (!view.valid || !hasChild(rootXfmName())
+      || !child(rootXfmName()).hasChild(standInName()))
+    return true;
+
+  // The stand-in is shared by the root transform and any instances
+  std::vector<affine3f> xfms;
+  placements(child(rootXfmName()).child(standInName()), one, xfms);
+  for (auto &xfm : xfms) {
+    if (view.intersects(xfmBounds(xfm, deferredBounds)))
+      return true;
+  }
+
+  return false;
+}
+
+box3f Importer::modelBounds() const
+{
+  return deferred ? deferredBounds : importedBounds;
+}
+
+void Importer::updateModelBounds()
+{
+  if (deferred || !hasChild(rootXfmName()))
+    return;
+
+  importedBounds = box3f(empty);
+  for (auto &c : child(rootXfmName()).children())
+    importedBounds.extend(c.second->bounds());
+}
+
+OSPSG_INTERFACE bool importNextDeferred(Node &camera, bool all)
+{
+  const ViewFrustum view(camera);
+
+  for (auto it = deferredImports.begin(); it != deferredImports.end();) {
+    auto importer = it->lock();
+    if (!importer || !importer->isDeferred()) {
+      it = deferredImports.erase(it);
+      continue;
+    }
+
+    if (all || importer->standInVisible(view)) {
+      // Importing may defer more models, which invalidates it
+      deferredImports.erase(it);
+      importer->importDeferred();
+      return true;
+    }
+    ++it;
+  }
+
+  return false;
+}
+
 OSPSG_INTERFACE void importScene(
     std::shared_ptr<StudioContext> context, rkcommon::FileName &sceneFileName)
 {
   std::cout << "Importing a scene" << std::endl;
+  SG_PROFILE_SCOPE("importScene", sceneFileName.str());
   context->filesToImport.clear();
+  context->importBounds.clear();
   std::ifstream sgFile(sceneFileName.str());
   if (!sgFile) {
     std::cerr << "Could not open " << sceneFileName << " for reading"
@@ -43,6 +191,11 @@ OSPSG_INTERFACE void importScene(
   JSON j;
   sgFile >> j;
 
+  // Material overrides are applied once the models are imported, those of
+  // deferred models would be replaced by the materials imported later.
+  // Models of such scenes aren't deferred.
+  context->sceneMaterials = j.contains("materialRegistry");
+
   std::map<std::string, JSON> jImporters;
   sg::NodePtr lights;
 
@@ -72,6 +225,8 @@ OSPSG_INTERFACE void importScene(
             std::ifstream f(tryFile);
             if (f.good()) {
               context->filesToImport.push_back(tryFile);
+              if (jChild.contains("bounds") && !context->sceneMaterials)
+                context->importBounds[tryFile] = jChild["bounds"].get<box3f>();
 
               jImporters[jChild["name"]] = jChild;
               break;
@@ -96,15 +251,19 @@ OSPSG_INTERFACE void importScene(
 
   // Any lights in the scenefile World are added here
   if (lights) {
+    std::vector<NodePtr> worldLights;
     for (auto &light : lights->children())
-      context->lightsManager->addLight(light.second);
+      worldLights.push_back(light.second);
+    context->lightsManager->addLights(worldLights);
   }
 
   // If the sceneFile contains a lightsManager, add those lights here
   if (j.contains("lightsManager")) {
     auto &jLights = j["lightsManager"];
+    std::vector<NodePtr> managerLights;
     for (auto &jLight : jLights["children"])
-      context->lightsManager->addLight(createNodeFromJSON(jLight));
+      managerLights.push_back(createNodeFromJSON(jLight));
+    context->lightsManager->addLights(managerLights);
   }
 
   // If the sceneFile contains materials, parse them here, after the model has
@@ -157,29 +316,23 @@ OSPSG_INTERFACE void importScene(
   // (must happen after refreshScene)
   auto world = context->frame->childNodeAs<sg::Node>("world");
 
-  for (auto &jImport : jImporters) {
-    // lamdba, find node by name
-    std::function<sg::NodePtr(const sg::NodePtr, const std::string &)>
-      findFirstChild = [&findFirstChild](const sg::NodePtr root,
-          const std::string &name) -> sg::NodePtr {
-        sg::NodePtr found = nullptr;
-
-        // Quick shallow top-level search first
-        for (auto child : root->children())
-          if (child.first == name)
-            return child.second;
-
-        // Next level, deeper search if not found
-        for (auto child : root->children()) {
-          found = findFirstChild(child.second, name);
-          if (found)
-            return found;
-        }
+  // Index the world once instead of searching it for every importer
+  NodeIndex worldIndex;
+  worldIndex.update(*world);
 
-        return found;
-      };
+  for (auto &jImport : jImporters) {
+    // find the shallowest node by name
+    sg::NodePtr importNode = nullptr;
+    size_t importDepth = 0;
+    for (auto &found : worldIndex.findByName(jImport.first)) {
+      const size_t depth =
+          std::count(found.first.begin(), found.first.end(), '/');
+      if (!importNode || depth < importDepth) {
+        importNode = found.second;
+        importDepth = depth;
+      }
+    }
 
-    auto importNode = findFirstChild(world, jImport.first);
     if (importNode) {
       // should be associated xfm node
       auto childName = jImport.second["children"][0]["name"];
@@ -201,6 +354,7 @@ OSPSG_INTERFACE void importScene(
 
 // global assets catalogue
 AssetsCatalogue cat;
+std::vector<std::weak_ptr<Importer>> deferredImports;
 
 } // namespace sg
 } // namespace ospray
@@ -8,6 +8,7 @@
 #include "sg/renderer/MaterialRegistry.h"
 #include "sg/scene/Animation.h"
 #include "sg/texture/Texture2D.h"
+#include "sg/camera/Camera.h"
 
 #include "../../app/ospStudio.h"
 
@@ -71,6 +72,51 @@ struct OSPSG_INTERFACE Importer : public Node
     lightsManager = _lightsManager;
   }
 
+  // Give meshes a simplified stand-in rendered while navigating, see
+  // sg::createLodMesh().  -1 for none, 0 for bounding boxes, else the grid
+  // size vertices are clustered on.
+  inline void setLodGridSize(int gridSize)
+  {
+    lodGridSize = gridSize;
+  }
+
+  // Defer the imports of the models a glTF file references, see
+  // deferImport()
+  inline void setDeferReferences(bool defer)
+  {
+    deferReferences = defer;
+  }
+
+  // Stand in for the model with a box of the given bounds, in the space of
+  // the root transform, until importDeferred() is called.  Nothing stands in
+  // for it if the bounds are empty.  The root transform is there right away,
+  // so it can be placed like an imported model.  The model's materials are
+  // only added to the registry by importDeferred(), replacing any of the
+  // same name, so changes made to them before are lost.
+  void deferImport(const box3f &bounds = empty);
+
+  // Import the model in place of its stand-in, keeping the root transform,
+  // also in the instances getImporter() made meanwhile
+  void importDeferred();
+
+  inline bool isDeferred() const
+  {
+    return deferred;
+  }
+
+  // Whether the stand-in may be visible to the view at any of its
+  // placements, or has no bounds
+  bool standInVisible(const ViewFrustum &view);
+
+  // Bounds of the model, or of its stand-in, in the space of the root
+  // transform, as of the last updateModelBounds().  Models imported from
+  // declared bounds keep them until then.
+  box3f modelBounds() const;
+
+  // Recompute the bounds of the imported model, committing it if needed.
+  // Call before serializing the importer, e.g. to save a scene.
+  void updateModelBounds();
+
   inline VolumeParams* setDefaultParams(bool structured) {
     if (structured) {
       defaultParams.voxelType = int(OSP_FLOAT);
@@ -97,11 +143,30 @@ struct OSPSG_INTERFACE Importer : public Node
   bool importCameras{false};
   VolumeParams *p{nullptr};
   NodePtr lightsManager;
+  int lodGridSize{-1};
+  bool deferReferences{false};
+
+ private:
+  inline std::string rootXfmName() const
+  {
+    return fileName.name() + "_rootXfm";
+  }
+
+  inline std::string standInName() const
+  {
+    return fileName.name() + "_standIn";
+  }
+
+  bool deferred{false};
+  box3f deferredBounds{empty};
+  box3f importedBounds{empty};
 };
 
 // global assets catalogue
 extern OSPSG_INTERFACE AssetsCatalogue cat;
 extern OSPSG_INTERFACE std::map<std::string, std::string> importerMap;
+// importers waiting for importDeferred(), in the order they were deferred
+extern OSPSG_INTERFACE std::vector<std::weak_ptr<Importer>> deferredImports;
 
 // Providing a unique transform instance as root to add existing imported model to, 
 // should probably be the responsibility of the calling routine
@@ -129,6 +194,7 @@ inline std::shared_ptr<Importer> getImporter(
       std::cout << "!!! error... importer rootXfm is missing?!" << std::endl;
     }
     auto &rootXfmNode = origNode->child(rootXfmName);
+    auto origImporter = std::static_pointer_cast<Importer>(origNode);
 
     // Create a unique instanceXfm nodeName
     auto count = 1;
@@ -138,7 +204,9 @@ inline std::shared_ptr<Importer> getImporter(
 
     auto instanceXfm = createNode(nodeName, "transform");
 
-    // Add all children of the original rootXfm to this instanceXfm
+    // Add all children of the original rootXfm to this instanceXfm.  A
+    // deferred import only has its stand-in yet, importDeferred() replaces
+    // it with the model in every instance.
     for (auto &g : rootXfmNode.children())
       instanceXfm->add(g.second);
 
@@ -167,8 +235,15 @@ inline std::shared_ptr<Importer> getImporter(
 inline void clearAssets()
 {
   cat.clear();
+  deferredImports.clear();
 }
 
+// Import the first deferred model whose stand-in may be visible to the
+// camera, or the first one whatever its visibility if all is set.  Returns
+// whether a model was imported.  The import runs synchronously, deferring
+// only spreads the imports over several calls.
+OSPSG_INTERFACE bool importNextDeferred(Node &camera, bool all = false);
+
 // for loading scene (.sg) files
 OSPSG_INTERFACE void importScene(
     std::shared_ptr<StudioContext> context, rkcommon::FileName &fileName);
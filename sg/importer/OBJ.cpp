@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Importer.h"
+#include "../scene/geometry/Lod.h"
 // tiny_obj_loader
 #include "tiny_obj_loader.h"
 // rkcommon
@@ -304,10 +305,14 @@ namespace ospray {
     if (materialNodes.empty())
       materialNodes.emplace_back(createNode("default", "obj"));
 
-    size_t baseMaterialOffset = materialRegistry->children().size();
-
-    for (auto m : materialNodes)
-      materialRegistry->add(m);
+    // Registry index of each OBJ material, identical materials may be merged
+    const auto merged = materialRegistry->mergedMaterials;
+    auto materialIDs = materialRegistry->addMaterials(materialNodes);
+    if (materialRegistry->mergedMaterials != merged) {
+      std::cout << "merged " << materialRegistry->mergedMaterials - merged
+                << " of " << materialNodes.size()
+                << " materials into existing ones\n";
+    }
 
     auto &attrib = objData.attrib;
 
@@ -367,16 +372,21 @@ namespace ospray {
       std::transform(shape.mesh.material_ids.begin(),
                      shape.mesh.material_ids.end(),
                      mIDs.begin(),
-                     [&](int i) { return i + baseMaterialOffset; });
-      mesh.createChildData("material", mIDs);
+                     [&](int i) { return materialIDs[std::max(i, 0)]; });
+      if (lodGridSize >= 0) {
+        mesh.nodeAs<Geometry>()->lod =
+            createLodMesh(name + "_lod", v, vi, mIDs, lodGridSize);
+      }
+
+      mesh.createChildData("material", std::move(mIDs));
       mesh.child("material").setSGOnly();
 
-      mesh.createChildData("vertex.position", v);
-      mesh.createChildData("index", vi);
+      mesh.createChildData("vertex.position", std::move(v));
+      mesh.createChildData("index", std::move(vi));
       if (!vn.empty())
-        mesh.createChildData("vertex.normal", vn);
+        mesh.createChildData("vertex.normal", std::move(vn));
       if (!vt.empty())
-        mesh.createChildData("vertex.texcoord", vt);
+        mesh.createChildData("vertex.texcoord", std::move(vt));
     }
 
     // Finally, add node hierarchy to importer parent
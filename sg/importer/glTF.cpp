@@ -7,14 +7,25 @@
 #include "tiny_gltf.h"
 // rkcommon
 #include "rkcommon/os/FileName.h"
+#include "rkcommon/tasking/parallel_for.h"
 
 #include "glTF/buffer_view.h"
 #include "glTF/gltf_types.h"
+#include "glTF/meshopt_decoder.h"
 
 #include "../scene/geometry/Geometry.h"
+#include "../scene/geometry/Lod.h"
 #include "../visitors/PrintNodes.h"
 #include "../texture/Texture2D.h"
 #include "../scene/Transform.h"
+// std
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <set>
+#include <type_traits>
+// json
+#include <json.hpp>
 // Note: may want to disable warnings/errors from TinyGLTF
 #define REPORT_TINYGLTF_WARNINGS
 
@@ -53,6 +64,7 @@ namespace ospray {
     const FileName &fileName;
 
     bool parseAsset();
+    bool decodeCompressedBufferViews();
     void createMaterials();
     void createSkins();
     void finalizeSkins();
@@ -66,6 +78,10 @@ namespace ospray {
     void applySceneBackground(NodePtr bgXfm);
     std::vector<NodePtr> lights;
 
+    // See Importer::setLodGridSize() and setDeferReferences()
+    int lodGridSize{-1};
+    bool deferReferences{false};
+
    private:
     NodePtr rootNode;
     std::vector<SkinPtr> skins;
@@ -77,7 +93,8 @@ namespace ospray {
 
     std::vector<NodePtr> ospMaterials;
 
-    size_t baseMaterialOffset = 0; // set in createMaterials()
+    // Registry index of each material, set in createMaterials()
+    std::vector<uint32_t> materialIDs;
 
     void loadKeyframeInput(int accessorID, std::vector<float> &kfInput);
 
@@ -125,6 +142,157 @@ namespace ospray {
     return std::string(std::max(0, length - (int)string.length()), p) + string;
   }
 
+  template <typename T, int N>
+  void readComponents(const tinygltf::Model &model,
+      const tinygltf::Accessor &accessor,
+      std::vector<vec_t<float, N>> &result)
+  {
+    const int components =
+        std::min(N, tinygltf::GetNumComponentsInType(accessor.type));
+
+    // Normalized integers map to [0, 1], or [-1, 1] if signed
+    const bool normalized = accessor.normalized && std::is_integral<T>::value;
+    const float scale =
+        normalized ? 1.f / float(std::numeric_limits<T>::max()) : 1.f;
+
+    BufferView view(model.bufferViews[accessor.bufferView],
+        model,
+        gltf_base_stride(accessor.type, accessor.componentType));
+    view.buf += accessor.byteOffset;
+
+    for (size_t i = 0; i < result.size(); ++i) {
+      const uint8_t *element = view[i];
+      for (int c = 0; c < components; ++c) {
+        T v;
+        std::memcpy(&v, element + c * sizeof(T), sizeof(T));
+        const float f = float(v) * scale;
+        result[i][c] = normalized ? std::max(f, -1.f) : f;
+      }
+    }
+  }
+
+  // Reads a vector attribute as floats.  KHR_mesh_quantization stores them
+  // as (normalized) integers too.  Components the attribute doesn't have are
+  // left at their defaults.
+  template <int N>
+  std::vector<vec_t<float, N>> readVectors(const tinygltf::Model &model,
+      const tinygltf::Accessor &accessor,
+      const vec_t<float, N> &defaults = vec_t<float, N>(0.f))
+  {
+    std::vector<vec_t<float, N>> result(accessor.count, defaults);
+
+    switch (accessor.componentType) {
+    case TINYGLTF_COMPONENT_TYPE_FLOAT:
+      readComponents<float>(model, accessor, result);
+      break;
+    case TINYGLTF_COMPONENT_TYPE_BYTE:
+      readComponents<int8_t>(model, accessor, result);
+      break;
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+      readComponents<uint8_t>(model, accessor, result);
+      break;
+    case TINYGLTF_COMPONENT_TYPE_SHORT:
+      readComponents<int16_t>(model, accessor, result);
+      break;
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+      readComponents<uint16_t>(model, accessor, result);
+      break;
+    default:
+      ERROR << "Unsupported attribute component type: "
+            << accessor.componentType << "\n";
+      throw std::runtime_error("Unsupported attribute component type");
+    }
+
+    return result;
+  }
+
+  // EXT_meshopt_compression fallback buffers may have no uri, readers that
+  // support the extension never look at their data.  tinygltf rejects
+  // buffers without data, so the asset's JSON gives them a one byte data uri
+  // instead.  Binary assets get their JSON chunk replaced, the BIN chunk is
+  // kept as is.
+  static void replaceMeshoptFallbackBuffers(
+      std::vector<unsigned char> &asset, bool binary)
+  {
+    size_t jsonBegin = 0;
+    size_t jsonLength = asset.size();
+    if (binary) {
+      if (asset.size() < 20)
+        return;
+      uint32_t chunkLength;
+      std::memcpy(&chunkLength, &asset[12], 4);
+      jsonBegin = 20;
+      jsonLength = chunkLength;
+      if (jsonBegin + jsonLength > asset.size())
+        return;
+    }
+
+    const std::string text(asset.begin() + jsonBegin,
+        asset.begin() + jsonBegin + jsonLength);
+    if (text.find("EXT_meshopt_compression") == std::string::npos)
+      return;
+
+    auto j = nlohmann::ordered_json::parse(text, nullptr, false);
+    if (j.is_discarded() || !j.contains("buffers"))
+      return;
+
+    bool replaced = false;
+    for (auto &buffer : j["buffers"]) {
+      if (!buffer.contains("uri") && buffer.contains("extensions")
+          && buffer["extensions"].contains("EXT_meshopt_compression")) {
+        buffer["uri"] = "data:application/octet-stream;base64,AA==";
+        buffer["byteLength"] = 1;
+        replaced = true;
+      }
+    }
+    if (!replaced)
+      return;
+
+    std::string json = j.dump();
+    if (!binary) {
+      asset.assign(json.begin(), json.end());
+      return;
+    }
+
+    // Chunks are 4 byte aligned, JSON is padded with spaces
+    json.resize((json.size() + 3) & ~size_t(3), ' ');
+    const uint32_t chunkLength = uint32_t(json.size());
+    const uint32_t chunkType = 0x4E4F534A; // "JSON"
+
+    std::vector<unsigned char> glb(asset.begin(), asset.begin() + 12);
+    glb.resize(20);
+    std::memcpy(&glb[12], &chunkLength, 4);
+    std::memcpy(&glb[16], &chunkType, 4);
+    glb.insert(glb.end(), json.begin(), json.end());
+    glb.insert(glb.end(), asset.begin() + jsonBegin + jsonLength, asset.end());
+
+    const uint32_t length = uint32_t(glb.size());
+    std::memcpy(&glb[8], &length, 4);
+    asset.swap(glb);
+  }
+
+  struct AssetFile
+  {
+    std::string fileName;
+    bool binary;
+  };
+
+  // Reads files for tinygltf, fixing up the asset itself on the way
+  static bool readGLTFFile(std::vector<unsigned char> *out,
+      std::string *err,
+      const std::string &filePath,
+      void *userData)
+  {
+    if (!tinygltf::ReadWholeFile(out, err, filePath, nullptr))
+      return false;
+
+    const auto *asset = static_cast<const AssetFile *>(userData);
+    if (filePath == asset->fileName)
+      replaceMeshoptFallbackBuffers(*out, asset->binary);
+
+    return true;
+  }
+
   bool GLTFData::parseAsset()
   {
     INFO << "TinyGLTF loading: " << fileName << "\n";
@@ -134,6 +302,15 @@ namespace ospray {
     bool ret;
 
     const auto isASCII = (fileName.ext() == "gltf");
+
+    AssetFile asset{fileName.str(), !isASCII};
+    tinygltf::FsCallbacks fs{&tinygltf::FileExists,
+        &tinygltf::ExpandFilePath,
+        &readGLTFFile,
+        &tinygltf::WriteWholeFile,
+        &asset};
+    context.SetFsCallbacks(fs);
+
     if (isASCII)
       ret = context.LoadASCIIFromFile(&model, &err, &warn, fileName);
     else
@@ -177,9 +354,20 @@ namespace ospray {
         WARN << "      " << ext << "\n";
     }
     if (!model.extensionsRequired.empty()) {
+      // Extensions which change how the file must be read
+      static const std::set<std::string> supported = {
+          "KHR_mesh_quantization", "EXT_meshopt_compression"};
       WARN << "   ExtensionsRequired:\n";
-      for (const auto &ext : model.extensionsRequired)
-        WARN << "      " << ext << "\n";
+      for (const auto &ext : model.extensionsRequired) {
+        WARN << "      " << ext
+             << (supported.count(ext) ? "\n" : " (not supported)\n");
+      }
+    }
+
+    if (!decodeCompressedBufferViews()) {
+      ERROR << "FATAL error decoding compressed buffers,"
+            << " no geometry added to the scene!" << std::endl;
+      return false;
     }
 
     // XXX
@@ -201,6 +389,70 @@ namespace ospray {
     return ret;
   }
 
+  bool GLTFData::decodeCompressedBufferViews()
+  {
+    std::vector<size_t> views;
+    for (size_t i = 0; i < model.bufferViews.size(); ++i) {
+      if (model.bufferViews[i].extensions.count("EXT_meshopt_compression"))
+        views.push_back(i);
+    }
+
+    if (views.empty())
+      return true;
+
+    INFO << "... decoding " << views.size() << " compressed bufferViews\n";
+
+    // Each view is decoded, in parallel, to a buffer of its own which the
+    // view then refers to, so accessors read it like any other
+    const size_t firstBuffer = model.buffers.size();
+    model.buffers.resize(firstBuffer + views.size());
+    std::atomic<bool> decoded{true};
+
+    tasking::parallel_for(views.size(), [&](size_t i) {
+      auto &view = model.bufferViews[views[i]];
+      const auto &ext = view.extensions.at("EXT_meshopt_compression");
+
+      auto number = [&](const char *name) -> size_t {
+        return ext.Has(name) ? size_t(ext.Get(name).GetNumberAsDouble()) : 0;
+      };
+      auto string = [&](const char *name, const char *value) {
+        return ext.Has(name) ? ext.Get(name).Get<std::string>()
+                             : std::string(value);
+      };
+
+      const size_t source = number("buffer");
+      const size_t byteOffset = number("byteOffset");
+      const size_t byteLength = number("byteLength");
+      const size_t byteStride = number("byteStride");
+      const size_t count = number("count");
+
+      if (source >= firstBuffer
+          || byteOffset + byteLength > model.buffers[source].data.size()) {
+        decoded = false;
+        return;
+      }
+
+      auto &data = model.buffers[firstBuffer + i].data;
+      data.resize(count * byteStride);
+      if (!decodeMeshopt(data.data(),
+              count,
+              byteStride,
+              model.buffers[source].data.data() + byteOffset,
+              byteLength,
+              string("mode", ""),
+              string("filter", "NONE"))) {
+        decoded = false;
+        return;
+      }
+
+      view.buffer = int(firstBuffer + i);
+      view.byteOffset = 0;
+      view.byteLength = data.size();
+    });
+
+    return decoded;
+  }
+
   void GLTFData::applySceneBackground(NodePtr bgXfm)
   {
     auto background = model.extensions.find("BIT_scene_background")->second;
@@ -253,13 +505,18 @@ namespace ospray {
     std::string refLinkFileName = refTitle + ".gltf";
     std::string refLinkFullPath = fileName.path() + refLinkFileName;
     rkcommon::FileName file(refLinkFullPath);
-    std::cout << "Importing: " << file << std::endl;
-
     auto importer =
         std::static_pointer_cast<sg::Importer>(sg::getImporter(sgNode, file));
     if (importer) {
       importer->setMaterialRegistry(materialRegistry);
-      importer->importScene();
+      importer->setLodGridSize(lodGridSize);
+      importer->setDeferReferences(deferReferences);
+      if (deferReferences)
+        importer->deferImport();
+      else {
+        std::cout << "Importing: " << file << std::endl;
+        importer->importScene();
+      }
     }
   }
 
@@ -326,9 +583,13 @@ namespace ospray {
       ospMaterials.push_back(createOSPMaterial(material));
     }
 
-    baseMaterialOffset = materialRegistry->children().size();
-    for (auto m : ospMaterials)
-      materialRegistry->add(m);
+    // Identical materials may be merged with ones already in the registry
+    const auto merged = materialRegistry->mergedMaterials;
+    materialIDs = materialRegistry->addMaterials(ospMaterials);
+    if (materialRegistry->mergedMaterials != merged) {
+      INFO << "merged " << materialRegistry->mergedMaterials - merged << " of "
+           << ospMaterials.size() << " materials into existing ones\n";
+    }
   }
 
   void GLTFData::createCameras(std::vector<NodePtr> &cameras)
@@ -678,39 +939,9 @@ namespace ospray {
     }
 
     // Colors: vec3/vec4 float/ubyte(N)/ushort(N) RGB/RGBA
-    // accessor->normalized
     auto fnd = prim.attributes.find("COLOR_0");
     if (fnd != prim.attributes.end()) {
-      auto col_attrib = fnd->second;
-      if (model.accessors[col_attrib].componentType ==
-          TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
-        Accessor<uint16_t> col_accessor(model.accessors[col_attrib], model);
-        vc.reserve(col_accessor.size() / 3);
-        for (size_t i = 0; i < col_accessor.size() / 3; ++i)
-          vc.emplace_back(vec4f(col_accessor[i * 3],
-                                col_accessor[i * 3 + 1],
-                                col_accessor[i * 3 + 2],
-                                1.f));
-      } else if (model.accessors[col_attrib].componentType ==
-                 TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
-        Accessor<uint8_t> col_accessor(model.accessors[col_attrib], model);
-        vc.reserve(col_accessor.size() / 3);
-        for (size_t i = 0; i < col_accessor.size() / 3; ++i)
-          vc.emplace_back(vec4f(col_accessor[i * 3],
-                                col_accessor[i * 3 + 1],
-                                col_accessor[i * 3 + 2],
-                                1.f));
-      } else if (model.accessors[col_attrib].componentType ==
-                 TINYGLTF_COMPONENT_TYPE_FLOAT) {
-        Accessor<vec4f> col_accessor(model.accessors[col_attrib], model);
-        vc.reserve(col_accessor.size());
-        for (size_t i = 0; i < col_accessor.size(); ++i)
-          vc.emplace_back(col_accessor[i]);
-      } else {
-        ERROR << "Unsupported color type: "
-              << model.accessors[col_attrib].componentType << "\n";
-        throw std::runtime_error("Unsupported color component type");
-      }
+      vc = readVectors<4>(model, model.accessors[fnd->second], vec4f(1.f));
 
       // If alphaMode is OPAQUE (or default material), leave colors unchanged,
       // but set all alpha to 1.f
@@ -723,17 +954,12 @@ namespace ospray {
       }
     }
 
-    // TexCoords: vec2 float/ubyte(N)/ushort(N)
-    // accessor->normalized
+    // TexCoords: vec2 float/byte(N)/ubyte(N)/short(N)/ushort(N)
     // Note: GLTF can have texture coordinates [0,1] used by different
     // textures.  Only supporting TEXCOORD_0
     fnd = prim.attributes.find("TEXCOORD_0");
-    if (fnd != prim.attributes.end()) {
-      Accessor<vec2f> uv_accessor(model.accessors[fnd->second], model);
-      vt.reserve(uv_accessor.size());
-      for (size_t i = 0; i < uv_accessor.size(); ++i)
-        vt.emplace_back(uv_accessor[i]);
-    }
+    if (fnd != prim.attributes.end())
+      vt = readVectors<2>(model, model.accessors[fnd->second]);
 #if 0 // OSPRay does not support a second uv texcoord set
       // But, specifying it here isn't a problem.  Only on attempted usage.
     fnd = prim.attributes.find("TEXCOORD_1");
@@ -757,31 +983,36 @@ namespace ospray {
       ospGeom =
           createNodeAs<Geometry>(primName + "_object", "geometry_triangles");
 
-      // Positions: vec3f
-      Accessor<vec3f> pos_accessor(
-          model.accessors[prim.attributes["POSITION"]], model);
-      ospGeom->skinnedPositions.reserve(pos_accessor.size());
-      for (size_t i = 0; i < pos_accessor.size(); ++i)
-        ospGeom->skinnedPositions.emplace_back(pos_accessor[i]);
+      // Positions: vec3 float/byte(N)/ubyte(N)/short(N)/ushort(N)
+      ospGeom->skinnedPositions =
+          readVectors<3>(model, model.accessors[prim.attributes["POSITION"]]);
       ospGeom->createChildData(
           "vertex.position", ospGeom->skinnedPositions, true);
 
-      // Normals: vec3f
+      // Normals: vec3 float/byte(N)/short(N)
       fnd = prim.attributes.find("NORMAL");
       if (fnd != prim.attributes.end()) {
-        Accessor<vec3f> normal_accessor(model.accessors[fnd->second], model);
-        ospGeom->skinnedNormals.reserve(normal_accessor.size());
-        for (size_t i = 0; i < normal_accessor.size(); ++i)
-          ospGeom->skinnedNormals.emplace_back(normal_accessor[i]);
+        ospGeom->skinnedNormals =
+            readVectors<3>(model, model.accessors[fnd->second]);
         ospGeom->createChildData(
             "vertex.normal", ospGeom->skinnedNormals, true);
       }
 
-      ospGeom->createChildData("index", vi);
+      // Skinned meshes move, a stand-in wouldn't follow
+      if (lodGridSize >= 0
+          && prim.attributes.find("JOINTS_0") == prim.attributes.end()) {
+        ospGeom->lod = createLodMesh(primName + "_lod",
+            ospGeom->skinnedPositions,
+            vi,
+            {materialIDs[prim.material + 1]},
+            lodGridSize);
+      }
+
+      ospGeom->createChildData("index", std::move(vi));
       if (!vc.empty())
-        ospGeom->createChildData("vertex.color", vc);
+        ospGeom->createChildData("vertex.color", std::move(vc));
       if (!vt.empty())
-        ospGeom->createChildData("vertex.texcoord", vt);
+        ospGeom->createChildData("vertex.texcoord", std::move(vt));
 
       // skinning, XXX for now only for triangles
       const auto fndj = prim.attributes.find("JOINTS_0");
@@ -809,21 +1040,11 @@ namespace ospray {
         auto &weights = model.accessors[fndw->second];
         isVec4 = weights.type == TINYGLTF_TYPE_VEC4;
         if (isVec4
-            && weights.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
-          Accessor<vec4uc> joint(weights, model);
-          for (size_t i = 0; i < joint.size(); ++i)
-            ospGeom->weights.emplace_back(joint[i]);
-        } else if (isVec4
-            && weights.componentType
-                == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
-          Accessor<vec4us> joint(weights, model);
-          for (size_t i = 0; i < joint.size(); ++i)
-            ospGeom->weights.emplace_back(joint[i]);
-        } else if (isVec4
-            && weights.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT) {
-          Accessor<vec4f> joint(weights, model);
-          for (size_t i = 0; i < joint.size(); ++i)
-            ospGeom->weights.emplace_back(joint[i]);
+            && (weights.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE
+                || weights.componentType
+                    == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT
+                || weights.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT)) {
+          ospGeom->weights = readVectors<4>(model, weights);
         } else {
           WARN << "invalid WEIGHTS_0\n";
           ospGeom->weights.resize(weights.count);
@@ -834,25 +1055,22 @@ namespace ospray {
       ospGeom =
           createNodeAs<Geometry>(primName + "_object", "geometry_spheres");
 
-      // Positions: vec3f
-      Accessor<vec3f> pos_accessor(
-          model.accessors[prim.attributes["POSITION"]], model);
-      ospGeom->positions.reserve(pos_accessor.size());
-      for (size_t i = 0; i < pos_accessor.size(); ++i)
-        ospGeom->positions.emplace_back(pos_accessor[i]);
+      // Positions: vec3 float/byte(N)/ubyte(N)/short(N)/ushort(N)
+      ospGeom->positions =
+          readVectors<3>(model, model.accessors[prim.attributes["POSITION"]]);
       ospGeom->createChildData("sphere.position", ospGeom->positions, true);
 
       // glTF doesn't specify point radius.
       ospGeom->createChild("radius", "float", 0.005f);
 
       if (!vc.empty()) {
-        ospGeom->createChildData("color", vc);
+        ospGeom->createChildData("color", std::move(vc));
         // color will be added to the geometric model, it is not directly part
         // of the spheres primitive
         ospGeom->child("color").setSGOnly();
       }
       if (!vt.empty())
-        ospGeom->createChildData("sphere.texcoord", vt);
+        ospGeom->createChildData("sphere.texcoord", std::move(vt));
     } else {
       ERROR << "Unsupported primitive mode! File must contain only "
         "triangles or points\n";
@@ -863,9 +1081,9 @@ namespace ospray {
 
     if (ospGeom) {
       // add one for default, "no material" material
-      auto materialID = prim.material + 1 + baseMaterialOffset;
+      auto materialID = materialIDs[prim.material + 1];
       std::vector<uint32_t> mIDs(ospGeom->skinnedPositions.size(), materialID);
-      ospGeom->createChildData("material", mIDs);
+      ospGeom->createChildData("material", std::move(mIDs));
       ospGeom->child("material").setSGOnly();
     }
 
@@ -1261,6 +1479,11 @@ namespace ospray {
     auto ospTexNode = createNode(texParam, "texture_2d");
     auto &ospTex    = *ospTexNode->nodeAs<Texture2D>();
 
+    // Identifies the texels for material de-duplication, the same image and
+    // channel of the same file are the same texture across imports
+    ospTex.fileName = fileName.str() + "#" + std::to_string(tex.source) + ":"
+        + std::to_string(colorChannel);
+
     ospTex.size.x = img.width;
     ospTex.size.y = img.height;
     ospTex.components = img.component;
@@ -1409,6 +1632,8 @@ namespace ospray {
     auto rootNode = createNode(baseName, "transform");
 
     GLTFData gltf(rootNode, fileName, materialRegistry);
+    gltf.lodGridSize = lodGridSize;
+    gltf.deferReferences = deferReferences;
 
     if (!gltf.parseAsset())
       return;
@@ -0,0 +1,497 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "meshopt_decoder.h"
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ospray {
+  namespace sg {
+
+  namespace {
+
+  // Vertex codec ///////////////////////////////////////////////////////////
+
+  constexpr size_t vertexBlockSizeBytes = 8192;
+  constexpr size_t vertexBlockMaxSize = 256;
+  constexpr size_t byteGroupSize = 16;
+  constexpr size_t byteGroupDecodeLimit = 24; // bytes a group may read
+  constexpr size_t tailMaxSize = 32;
+
+  inline uint8_t unzigzag8(uint8_t v)
+  {
+    return uint8_t(-(v & 1) ^ (v >> 1));
+  }
+
+  const uint8_t *decodeBytesGroup(
+      const uint8_t *data, uint8_t *buffer, int bitslog2)
+  {
+    switch (bitslog2) {
+    case 0:
+      std::memset(buffer, 0, byteGroupSize);
+      return data;
+    case 3:
+      std::memcpy(buffer, data, byteGroupSize);
+      return data + byteGroupSize;
+    default: {
+      // 2 or 4 bit values, high bits first.  The largest value escapes to a
+      // byte following the packed values.
+      const size_t bits = size_t(1) << bitslog2;
+      const uint8_t escape = uint8_t((1 << bits) - 1);
+      const uint8_t *extra = data + byteGroupSize * bits / 8;
+      for (size_t i = 0; i < byteGroupSize; i++) {
+        const size_t bit = i * bits;
+        const uint8_t enc = (data[bit / 8] >> (8 - bits - bit % 8)) & escape;
+        buffer[i] = enc == escape ? *extra++ : enc;
+      }
+      return extra;
+    }
+    }
+  }
+
+  const uint8_t *decodeBytes(const uint8_t *data,
+      const uint8_t *end,
+      uint8_t *buffer,
+      size_t bufferSize)
+  {
+    // 2 bits of header per group of bytes
+    const uint8_t *header = data;
+    const size_t headerSize = (bufferSize / byteGroupSize + 3) / 4;
+    if (size_t(end - data) < headerSize)
+      return nullptr;
+    data += headerSize;
+
+    for (size_t i = 0; i < bufferSize; i += byteGroupSize) {
+      if (size_t(end - data) < byteGroupDecodeLimit)
+        return nullptr;
+      const size_t group = i / byteGroupSize;
+      const int bitslog2 = (header[group / 4] >> ((group % 4) * 2)) & 3;
+      data = decodeBytesGroup(data, buffer + i, bitslog2);
+    }
+
+    return data;
+  }
+
+  const uint8_t *decodeVertexBlock(const uint8_t *data,
+      const uint8_t *end,
+      uint8_t *vertices,
+      size_t count,
+      size_t stride,
+      uint8_t *last)
+  {
+    uint8_t buffer[vertexBlockMaxSize];
+    const size_t countAligned =
+        (count + byteGroupSize - 1) & ~(byteGroupSize - 1);
+
+    // Each byte of a vertex is stored separately, as deltas to the byte of
+    // the previous vertex
+    for (size_t k = 0; k < stride; k++) {
+      data = decodeBytes(data, end, buffer, countAligned);
+      if (!data)
+        return nullptr;
+
+      uint8_t p = last[k];
+      for (size_t i = 0; i < count; i++) {
+        p += unzigzag8(buffer[i]);
+        vertices[i * stride + k] = p;
+      }
+      last[k] = p;
+    }
+
+    return data;
+  }
+
+  bool decodeVertices(uint8_t *dst,
+      size_t count,
+      size_t stride,
+      const uint8_t *src,
+      size_t size)
+  {
+    if (stride == 0 || stride > 256 || stride % 4 != 0 || size < 1 + stride)
+      return false;
+    if ((src[0] & 0xf0) != 0xa0 || (src[0] & 0x0f) > 0)
+      return false;
+
+    const uint8_t *data = src + 1;
+    const uint8_t *end = src + size;
+
+    // The tail ends with the vertex the first deltas are relative to
+    uint8_t last[256];
+    std::memcpy(last, end - stride, stride);
+
+    const size_t blockSize = std::min(
+        (vertexBlockSizeBytes / stride) & ~(byteGroupSize - 1),
+        vertexBlockMaxSize);
+
+    for (size_t offset = 0; offset < count; offset += blockSize) {
+      const size_t n = std::min(blockSize, count - offset);
+      data = decodeVertexBlock(
+          data, end, dst + offset * stride, n, stride, last);
+      if (!data)
+        return false;
+    }
+
+    return size_t(end - data) == std::max(stride, tailMaxSize);
+  }
+
+  // Index codecs ///////////////////////////////////////////////////////////
+
+  inline uint32_t decodeVByte(const uint8_t *&data)
+  {
+    const uint8_t lead = *data++;
+    if (lead < 128)
+      return lead;
+
+    uint32_t result = lead & 127;
+    uint32_t shift = 7;
+    for (int i = 0; i < 4; i++) {
+      const uint8_t group = *data++;
+      result |= uint32_t(group & 127) << shift;
+      shift += 7;
+      if (group < 128)
+        break;
+    }
+    return result;
+  }
+
+  inline uint32_t decodeIndex(const uint8_t *&data, uint32_t last)
+  {
+    const uint32_t v = decodeVByte(data);
+    return last + ((v >> 1) ^ -int32_t(v & 1));
+  }
+
+  inline void writeIndex(uint8_t *dst, size_t i, size_t indexSize, uint32_t v)
+  {
+    if (indexSize == 2) {
+      const uint16_t v16 = uint16_t(v);
+      std::memcpy(dst + i * 2, &v16, 2);
+    } else
+      std::memcpy(dst + i * 4, &v, 4);
+  }
+
+  struct IndexFifos
+  {
+    // Recently seen edges and vertices, indexed backwards from the offsets
+    uint32_t edges[16][2];
+    uint32_t vertices[16];
+    size_t edgeOffset{0};
+    size_t vertexOffset{0};
+
+    IndexFifos()
+    {
+      std::memset(edges, -1, sizeof(edges));
+      std::memset(vertices, -1, sizeof(vertices));
+    }
+
+    void pushEdge(uint32_t a, uint32_t b)
+    {
+      edges[edgeOffset][0] = a;
+      edges[edgeOffset][1] = b;
+      edgeOffset = (edgeOffset + 1) & 15;
+    }
+
+    void pushVertex(uint32_t v, bool advance = true)
+    {
+      vertices[vertexOffset] = v;
+      vertexOffset = (vertexOffset + advance) & 15;
+    }
+
+    void pushTriangleEdges(uint32_t a, uint32_t b, uint32_t c)
+    {
+      pushEdge(b, a);
+      pushEdge(c, b);
+      pushEdge(a, c);
+    }
+  };
+
+  bool decodeTriangles(uint8_t *dst,
+      size_t count,
+      size_t indexSize,
+      const uint8_t *src,
+      size_t size)
+  {
+    // A code byte per triangle and the 16 byte table of auxiliary codes
+    if (count % 3 != 0 || size < 1 + count / 3 + 16)
+      return false;
+    if ((src[0] & 0xf0) != 0xe0 || (src[0] & 0x0f) > 1)
+      return false;
+
+    const int fecmax = (src[0] & 0x0f) >= 1 ? 13 : 15;
+
+    const uint8_t *code = src + 1;
+    const uint8_t *data = code + count / 3;
+    const uint8_t *dataEnd = src + size - 16;
+    const uint8_t *codeauxTable = dataEnd;
+
+    IndexFifos fifo;
+    uint32_t next = 0;
+    uint32_t last = 0;
+
+    for (size_t i = 0; i < count; i += 3) {
+      // A triangle reads at most 16 bytes of data, the table of auxiliary
+      // codes pads the end
+      if (data > dataEnd)
+        return false;
+
+      const uint8_t codetri = *code++;
+
+      if (codetri < 0xf0) {
+        // Triangle on a recent edge
+        const int fe = codetri >> 4;
+        const uint32_t a = fifo.edges[(fifo.edgeOffset - 1 - fe) & 15][0];
+        const uint32_t b = fifo.edges[(fifo.edgeOffset - 1 - fe) & 15][1];
+
+        const int fec = codetri & 15;
+        uint32_t c;
+        bool advance = true;
+        if (fec < fecmax) {
+          // A new or recent vertex
+          if (fec == 0)
+            c = next++;
+          else {
+            c = fifo.vertices[(fifo.vertexOffset - 1 - fec) & 15];
+            advance = false;
+          }
+        } else {
+          // 13 and 14 are the last free index -1 and +1
+          last = c = fec != 15 ? last + (fec - (fec ^ 3))
+                               : decodeIndex(data, last);
+        }
+
+        writeIndex(dst, i + 0, indexSize, a);
+        writeIndex(dst, i + 1, indexSize, b);
+        writeIndex(dst, i + 2, indexSize, c);
+
+        fifo.pushVertex(c, advance);
+        fifo.pushEdge(c, b);
+        fifo.pushEdge(a, c);
+      } else if (codetri < 0xfe) {
+        // Triangle on new or recent vertices, coded in the table
+        const uint8_t codeaux = codeauxTable[codetri & 15];
+        const int feb = codeaux >> 4;
+        const int fec = codeaux & 15;
+
+        const uint32_t a = next++;
+        const uint32_t b = feb == 0
+            ? next++
+            : fifo.vertices[(fifo.vertexOffset - feb) & 15];
+        const uint32_t c = fec == 0
+            ? next++
+            : fifo.vertices[(fifo.vertexOffset - fec) & 15];
+
+        writeIndex(dst, i + 0, indexSize, a);
+        writeIndex(dst, i + 1, indexSize, b);
+        writeIndex(dst, i + 2, indexSize, c);
+
+        fifo.pushVertex(a);
+        fifo.pushVertex(b, feb == 0);
+        fifo.pushVertex(c, fec == 0);
+        fifo.pushTriangleEdges(a, b, c);
+      } else {
+        // Triangle on new, recent or free vertices, coded in a data byte
+        const uint8_t codeaux = *data++;
+        const int fea = codetri == 0xfe ? 0 : 15;
+        const int feb = codeaux >> 4;
+        const int fec = codeaux & 15;
+
+        if (codeaux == 0)
+          next = 0;
+
+        uint32_t a = fea == 0 ? next++ : 0;
+        uint32_t b = feb == 0
+            ? next++
+            : fifo.vertices[(fifo.vertexOffset - feb) & 15];
+        uint32_t c = fec == 0
+            ? next++
+            : fifo.vertices[(fifo.vertexOffset - fec) & 15];
+
+        // Free indices are deltas to the previous free index
+        if (fea == 15)
+          last = a = decodeIndex(data, last);
+        if (feb == 15)
+          last = b = decodeIndex(data, last);
+        if (fec == 15)
+          last = c = decodeIndex(data, last);
+
+        writeIndex(dst, i + 0, indexSize, a);
+        writeIndex(dst, i + 1, indexSize, b);
+        writeIndex(dst, i + 2, indexSize, c);
+
+        fifo.pushVertex(a);
+        fifo.pushVertex(b, feb == 0 || feb == 15);
+        fifo.pushVertex(c, fec == 0 || fec == 15);
+        fifo.pushTriangleEdges(a, b, c);
+      }
+    }
+
+    return data == dataEnd;
+  }
+
+  bool decodeIndices(uint8_t *dst,
+      size_t count,
+      size_t indexSize,
+      const uint8_t *src,
+      size_t size)
+  {
+    // A byte per index at least and a 4 byte tail
+    if (size < 1 + count + 4)
+      return false;
+    if ((src[0] & 0xf0) != 0xd0 || (src[0] & 0x0f) > 1)
+      return false;
+
+    const uint8_t *data = src + 1;
+    const uint8_t *dataEnd = src + size - 4;
+
+    // Indices are deltas to either of two previous indices
+    uint32_t last[2] = {0, 0};
+
+    for (size_t i = 0; i < count; i++) {
+      // An index reads at most 5 bytes, the tail pads the end
+      if (data >= dataEnd)
+        return false;
+
+      uint32_t v = decodeVByte(data);
+      const uint32_t baseline = v & 1;
+      v >>= 1;
+
+      const uint32_t index = last[baseline] + ((v >> 1) ^ -int32_t(v & 1));
+      last[baseline] = index;
+
+      writeIndex(dst, i, indexSize, index);
+    }
+
+    return data == dataEnd;
+  }
+
+  // Filters ////////////////////////////////////////////////////////////////
+
+  inline int roundToInt(float v)
+  {
+    return int(v + (v >= 0.f ? 0.5f : -0.5f));
+  }
+
+  template <typename T>
+  void decodeOctahedral(uint8_t *data, size_t count)
+  {
+    const float maxValue = float((1 << (sizeof(T) * 8 - 1)) - 1);
+
+    for (size_t i = 0; i < count; i++) {
+      T n[4];
+      std::memcpy(n, data + i * sizeof(n), sizeof(n));
+
+      // z holds the encoding of 1.f, unfold the lower hemisphere
+      float x = float(n[0]);
+      float y = float(n[1]);
+      const float z = float(n[2]) - std::fabs(x) - std::fabs(y);
+      const float t = std::min(z, 0.f);
+      x += x >= 0.f ? t : -t;
+      y += y >= 0.f ? t : -t;
+
+      const float s = maxValue / std::sqrt(x * x + y * y + z * z);
+      n[0] = T(roundToInt(x * s));
+      n[1] = T(roundToInt(y * s));
+      n[2] = T(roundToInt(z * s));
+
+      std::memcpy(data + i * sizeof(n), n, sizeof(n));
+    }
+  }
+
+  void decodeQuaternion(uint8_t *data, size_t count)
+  {
+    const float scale = 1.f / std::sqrt(2.f);
+
+    for (size_t i = 0; i < count; i++) {
+      int16_t q[4];
+      std::memcpy(q, data + i * sizeof(q), sizeof(q));
+
+      // The 4th component holds the scale and which component was dropped,
+      // the largest, which is reconstructed
+      const float s = scale / float(q[3] | 3);
+      const float x = q[0] * s;
+      const float y = q[1] * s;
+      const float z = q[2] * s;
+      const float w = std::sqrt(std::max(1.f - x * x - y * y - z * z, 0.f));
+
+      const int qc = q[3] & 3;
+      int16_t r[4];
+      r[(qc + 1) & 3] = int16_t(roundToInt(x * 32767.f));
+      r[(qc + 2) & 3] = int16_t(roundToInt(y * 32767.f));
+      r[(qc + 3) & 3] = int16_t(roundToInt(z * 32767.f));
+      r[(qc + 0) & 3] = int16_t(roundToInt(w * 32767.f));
+
+      std::memcpy(data + i * sizeof(r), r, sizeof(r));
+    }
+  }
+
+  void decodeExponential(uint8_t *data, size_t count)
+  {
+    for (size_t i = 0; i < count; i++) {
+      uint32_t v;
+      std::memcpy(&v, data + i * 4, 4);
+
+      // 24 bit signed mantissa and 8 bit signed exponent
+      const int32_t m = int32_t(v << 8) >> 8;
+      const int32_t e = int32_t(v) >> 24;
+      const float f = std::ldexp(float(m), e);
+
+      std::memcpy(data + i * 4, &f, 4);
+    }
+  }
+
+  bool applyFilter(
+      uint8_t *data, size_t count, size_t stride, const std::string &filter)
+  {
+    if (filter == "NONE")
+      return true;
+
+    if (filter == "OCTAHEDRAL") {
+      if (stride == 4)
+        decodeOctahedral<int8_t>(data, count);
+      else if (stride == 8)
+        decodeOctahedral<int16_t>(data, count);
+      else
+        return false;
+    } else if (filter == "QUATERNION") {
+      if (stride != 8)
+        return false;
+      decodeQuaternion(data, count);
+    } else if (filter == "EXPONENTIAL") {
+      if (stride % 4 != 0)
+        return false;
+      decodeExponential(data, count * stride / 4);
+    } else
+      return false;
+
+    return true;
+  }
+
+  } // namespace
+
+  bool decodeMeshopt(uint8_t *dst,
+      size_t count,
+      size_t stride,
+      const uint8_t *src,
+      size_t size,
+      const std::string &mode,
+      const std::string &filter)
+  {
+    if (mode == "ATTRIBUTES") {
+      return decodeVertices(dst, count, stride, src, size)
+          && applyFilter(dst, count, stride, filter);
+    }
+
+    if (stride != 2 && stride != 4)
+      return false;
+
+    if (mode == "TRIANGLES")
+      return decodeTriangles(dst, count, stride, src, size);
+    if (mode == "INDICES")
+      return decodeIndices(dst, count, stride, src, size);
+
+    return false;
+  }
+
+  }  // namespace sg
+} // namespace ospray
@@ -0,0 +1,33 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "sg/Node.h"
+// std
+#include <cstdint>
+#include <string>
+
+namespace ospray {
+  namespace sg {
+
+  // Decoder for bufferViews compressed with EXT_meshopt_compression, the
+  // meshoptimizer vertex codec (version 0) and index codecs (versions 0 and
+  // 1), see
+  // https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Vendor/EXT_meshopt_compression
+  //
+  // mode is "ATTRIBUTES", "TRIANGLES" or "INDICES" and filter "NONE",
+  // "OCTAHEDRAL", "QUATERNION" or "EXPONENTIAL", as in the extension.  dst
+  // holds count elements of stride bytes.  Returns false if the stream is
+  // malformed or truncated, dst is then partly written.
+
+  OSPSG_INTERFACE bool decodeMeshopt(uint8_t *dst,
+      size_t count,
+      size_t stride,
+      const uint8_t *src,
+      size_t size,
+      const std::string &mode,
+      const std::string &filter = "NONE");
+
+  }  // namespace sg
+} // namespace ospray
@@ -2,10 +2,46 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "MaterialRegistry.h"
+#include "../JSONDefs.h"
+// std
+#include <cstdint>
+#include <map>
 
 namespace ospray {
   namespace sg {
 
+  // Canonical description of a material, equal for materials which render
+  // the same: the type, the parameters sorted by name and the textures by
+  // the file or data they were created from
+  static std::string materialKey(const Node &material)
+  {
+    std::map<std::string, JSON> params;
+    for (auto &c : material.children()) {
+      auto &child = *c.second;
+      if (c.first == "handles")
+        continue;
+
+      JSON param = child;
+      if (child.type() == NodeType::TEXTURE) {
+        // to_json() leaves out the texel data
+        auto *texture = dynamic_cast<const Texture2D *>(&child);
+        if (texture && !texture->fileName.empty())
+          param["source"] = texture->fileName;
+        else if (child.hasChild("data"))
+          param["source"] = std::to_string(uintptr_t(&child.child("data")));
+        else
+          param["source"] = std::to_string(uintptr_t(&child));
+      }
+      params[c.first] = param;
+    }
+
+    JSON key = {{"type", material.subType()}};
+    for (auto &p : params)
+      key["params"][p.first] = p.second;
+
+    return key.dump();
+  }
+
   MaterialRegistry::MaterialRegistry()
   {
     // ensure there's one OBJ material in the Registry as the default material
@@ -30,26 +66,141 @@ namespace ospray {
     commit();
   }
 
-  void MaterialRegistry::updateMaterialList(const std::string &rType) 
+  bool MaterialRegistry::updateMaterialList(const std::string &rType) 
   {
     commit();
+
+    auto &list = materialLists[rType];
+    const bool switched = rType != listRendererType;
+    listRendererType = rType;
+
+    if (listIsCurrent(list)) {
+      if (switched)
+        cppMaterialList = list.cppMaterials;
+      return false;
+    }
+
     createCPPMaterials(rType);
-    sgMaterialList.clear();
-    cppMaterialList.clear();
+    list.sgMaterials.clear();
+    list.cppMaterials.clear();
     auto &mats = children();
+    list.sgMaterials.reserve(mats.size());
+    list.cppMaterials.reserve(mats.size());
 
     for (auto &m : mats) {
       auto &matHandle = m.second->child("handles");
       auto sgMaterial = m.second->nodeAs<sg::Material>();
-      sgMaterialList.push_back(sgMaterial);
+      list.sgMaterials.push_back(sgMaterial);
       if (m.second->nodeAs<Material>()->osprayMaterialType() == "obj" ||
           rType == "pathtracer") {
         auto &cppMaterial = matHandle.child(rType).valueAs<cpp::Material>();
-        cppMaterialList.push_back(cppMaterial);
+        list.cppMaterials.push_back(cppMaterial);
       }
     }
+
+    // Creating handles modified the structure, take the time afterwards
+    list.structureTime = structureLastModified();
+    cppMaterialList = list.cppMaterials;
+    return true;
   } 
 
+  bool MaterialRegistry::listIsCurrent(MaterialList &list)
+  {
+    if (list.structureTime == 0)
+      return false;
+    if (structureLastModified() == list.structureTime)
+      return true;
+
+    // The structure also changes when the handles of another renderer type
+    // are created, the list only needs rebuilding if the materials differ
+    auto &mats = children();
+    if (mats.size() != list.sgMaterials.size())
+      return false;
+
+    size_t i = 0;
+    for (auto &m : mats)
+      if (m.second.get() != list.sgMaterials[i++].get())
+        return false;
+
+    list.structureTime = structureLastModified();
+    return true;
+  }
+
+  std::vector<uint32_t> MaterialRegistry::addMaterials(
+      const std::vector<NodePtr> &materials)
+  {
+    if (deduplicate)
+      updateMaterialKeys();
+
+    std::vector<uint32_t> ids;
+    ids.reserve(materials.size());
+
+    for (auto &m : materials) {
+      if (!deduplicate) {
+        ids.push_back(addMaterial(m));
+        continue;
+      }
+
+      auto key = materialKey(*m);
+      auto found = materialKeys.find(key);
+      if (found != materialKeys.end()) {
+        ids.push_back(found->second);
+        mergedMaterials++;
+      } else {
+        const auto index = addMaterial(m);
+        // Drop the key of a material this one replaced
+        if (index + 1 < children().size()) {
+          for (auto k = materialKeys.begin(); k != materialKeys.end();) {
+            if (k->second == index)
+              k = materialKeys.erase(k);
+            else
+              ++k;
+          }
+        }
+        materialKeys[key] = index;
+        ids.push_back(index);
+      }
+    }
+
+    materialKeysTime = TimeStamp();
+    return ids;
+  }
+
+  uint32_t MaterialRegistry::addMaterial(NodePtr material)
+  {
+    // A material replacing one of the same name takes over its index
+    auto &mats = children();
+    if (mats.contains(material->name())) {
+      uint32_t index = 0;
+      for (auto &m : mats) {
+        if (m.first == material->name())
+          break;
+        index++;
+      }
+      add(material);
+      return index;
+    }
+
+    add(material);
+    return mats.size() - 1;
+  }
+
+  void MaterialRegistry::updateMaterialKeys()
+  {
+    // Keys are kept between imports, rebuild them only if materials were
+    // added, removed or edited since
+    if (!modifiedSince(materialKeysTime)
+        && structureLastModified() <= materialKeysTime)
+      return;
+
+    materialKeys.clear();
+    uint32_t index = 0;
+    for (auto &m : children())
+      materialKeys.emplace(materialKey(*m.second), index++);
+
+    materialKeysTime = TimeStamp();
+  }
+
   OSP_REGISTER_SG_NODE_NAME(MaterialRegistry, materialRegistry);
 
   }  // namespace sg
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #pragma once
+#include <map>
+#include <unordered_map>
 #include <vector>
 #include "../Node.h"
 #include "../visitors/GenerateOSPRayMaterials.h"
@@ -15,12 +17,47 @@ struct OSPSG_INTERFACE MaterialRegistry : public Node
   ~MaterialRegistry() override = default;
 
   void createCPPMaterials(const std::string &rType);
-  void updateMaterialList(const std::string &rType);
+
+  // Commits pending material edits and makes cppMaterialList the material
+  // list of renderer type rType.  Edits are committed to the existing
+  // handles and the list of every type used so far is kept, so a list is only
+  // rebuilt when materials were added or removed since it was last used.
+  // Returns true if the list of rType changed and needs to be passed to a
+  // renderer of that type again.
+  bool updateMaterialList(const std::string &rType);
+
+  // Adds materials, e.g. those created by an importer, and returns the
+  // registry index each of them ended up at, to be used as geometry material
+  // IDs.  With deduplicate set, a material identical to one already in the
+  // registry (same type, parameters and textures) isn't added, the index of
+  // the existing one is returned and mergedMaterials counts it.
+  std::vector<uint32_t> addMaterials(const std::vector<NodePtr> &materials);
 
   std::vector<cpp::Material> cppMaterialList;
 
+  bool deduplicate{false};
+  size_t mergedMaterials{0};
+
  private:
-  std::vector<std::shared_ptr<sg::Material>> sgMaterialList;
+  uint32_t addMaterial(NodePtr material);
+  void updateMaterialKeys();
+
+  struct MaterialList
+  {
+    std::vector<cpp::Material> cppMaterials;
+    std::vector<std::shared_ptr<sg::Material>> sgMaterials;
+    size_t structureTime{0}; // of the registry when last brought up to date
+  };
+
+  bool listIsCurrent(MaterialList &list);
+
+  // Material lists by renderer type, and the type in cppMaterialList
+  std::map<std::string, MaterialList> materialLists;
+  std::string listRendererType;
+
+  // Registry index of each material by its canonical description
+  std::unordered_map<std::string, uint32_t> materialKeys;
+  size_t materialKeysTime{0};
 };
 
 } // namespace sg
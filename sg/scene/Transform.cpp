@@ -19,6 +19,26 @@ NodeType Transform::type() const
   return NodeType::TRANSFORM;
 }
 
+affine3f Transform::localXfm()
+{
+  affine3f xfm = affine3f::rotate(child("rotation").valueAs<quaternionf>())
+      * affine3f::scale(child("scale").valueAs<vec3f>());
+  xfm.p = child("translation").valueAs<vec3f>();
+  return xfm * valueAs<affine3f>();
+}
+
+box3f Transform::bounds()
+{
+  if (modifiedSince(boundsMTime)) {
+    const box3f local = childrenBounds();
+    cachedBounds = local.empty() ? local : xfmBounds(localXfm(), local);
+    // Uncommitted geometry below only reports its last bounds
+    if (!subtreeModifiedButNotCommitted())
+      boundsMTime.renew();
+  }
+  return cachedBounds;
+}
+
 OSP_REGISTER_SG_NODE_NAME(Transform, transform);
 
 } // namespace sg
@@ -15,7 +15,17 @@ struct OSPSG_INTERFACE Transform : public Node_T<affine3f>
 
   NodeType type() const override;
 
+  // Local transform, as composed by RenderScene
+  affine3f localXfm();
+
+  // Children bounds in the parent's space, cached until the subtree changes
+  box3f bounds() override;
+
   affine3f accumulatedXfm{one};
+
+ private:
+  box3f cachedBounds{empty};
+  TimeStamp boundsMTime;
 };
 
 } // namespace sg
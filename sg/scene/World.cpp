@@ -2,8 +2,13 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "World.h"
+#include "../camera/Camera.h"
 #include "../visitors/RenderScene.h"
 #include "../fb/FrameBuffer.h"
+#include "../Profiler.h"
+// std
+#include <cmath>
+#include <limits>
 
 namespace ospray {
 namespace sg {
@@ -20,15 +25,113 @@ void World::preCommit()
 
 void World::postCommit()
 {
+  snapshot.update(*this);
+
+  SG_PROFILE_SCOPE("RenderScene");
   if (child("saveMetaData").valueAs<bool>()){
     auto &frame = parents().front();
     auto &fb = frame->childAs<sg::FrameBuffer>("framebuffer");
     auto &geomIdmap = fb.ge;
     auto &instanceIdmap = fb.in;
-    traverse<RenderScene>(geomIdmap, instanceIdmap);
+    snapshot.traverse(RenderScene(geomIdmap, instanceIdmap));
+  }
+  else
+    snapshot.traverse(RenderScene());
+}
+
+box3f World::bounds()
+{
+  if (modifiedSince(boundsMTime)) {
+    cachedBounds = childrenBounds();
+    // Uncommitted geometry below only reports its last bounds
+    if (!subtreeModifiedButNotCommitted())
+      boundsMTime.renew();
   }
+  return cachedBounds;
+}
+
+void World::setInstances(std::vector<cpp::Instance> &&_instances,
+    std::vector<box3f> &&bounds,
+    std::vector<cpp::Instance> &&_lodInstances,
+    std::vector<int32_t> &&lods)
+{
+  instances = std::move(_instances);
+  instanceBounds = std::move(bounds);
+  lodInstances = std::move(_lodInstances);
+  instanceLods = std::move(lods);
+  placedInstances.clear();
+  culled = false;
+}
+
+bool World::cullInstances(Node &camera,
+    const vec2i &frameSize,
+    bool frustum,
+    float minPixels,
+    float lodPixels)
+{
+  const ViewFrustum view(camera);
+  if (!view.valid)
+    return uncullInstances();
+
+  std::vector<uint32_t> placed;
+  placed.reserve(instances.size());
+
+  for (uint32_t i = 0; i < instanceBounds.size(); i++) {
+    const auto &b = instanceBounds[i];
+    if (b.empty()) {
+      placed.push_back(i);
+      continue;
+    }
+
+    if (frustum && !view.intersects(b))
+      continue;
+
+    const float pixels = view.projectedPixels(b, frameSize.y);
+    if (pixels < minPixels)
+      continue;
+
+    if (pixels < lodPixels && instanceLods[i] >= 0)
+      placed.push_back(i | placedLod);
+    else
+      placed.push_back(i);
+  }
+
+  if (culled && placed == placedInstances)
+    return false;
+
+  std::vector<cpp::Instance> placedHandles;
+  placedHandles.reserve(placed.size());
+  for (auto i : placed) {
+    if (i & placedLod)
+      placedHandles.push_back(lodInstances[instanceLods[i & ~placedLod]]);
+    else
+      placedHandles.push_back(instances[i]);
+  }
+  placeInstances(placedHandles);
+
+  placedInstances = std::move(placed);
+  culled = true;
+  return true;
+}
+
+bool World::uncullInstances()
+{
+  if (!culled)
+    return false;
+
+  placeInstances(instances);
+  placedInstances.clear();
+  culled = false;
+  return true;
+}
+
+void World::placeInstances(const std::vector<cpp::Instance> &placed)
+{
+  const auto &world = handle();
+  if (!placed.empty())
+    world.setParam("instance", cpp::CopiedData(placed));
   else
-    traverse<RenderScene>();
+    world.removeParam("instance");
 }
 
 OSP_REGISTER_SG_NODE_NAME(World, world);
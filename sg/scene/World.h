@@ -4,6 +4,7 @@
 #pragma once
 
 #include "../Node.h"
+#include "../NodeSnapshot.h"
 
 namespace ospray {
   namespace sg {
@@ -15,6 +16,64 @@ namespace ospray {
 
     virtual void preCommit() override;
     virtual void postCommit() override;
+
+    // Union of the instanced content, cached until the world is modified
+    box3f bounds() override;
+
+    // Flattened view of the world, RenderScene iterates it linearly
+    NodeSnapshot snapshot;
+
+    // Instances placed by RenderScene, with their world space bounds.  Empty
+    // bounds mark instances which are never culled, e.g. clipping geometry.
+    // lods holds the index in lodInstances of each instance's stand-in made
+    // of simplified geometry, -1 if it has none.
+    void setInstances(std::vector<cpp::Instance> &&instances,
+        std::vector<box3f> &&bounds,
+        std::vector<cpp::Instance> &&lodInstances,
+        std::vector<int32_t> &&lods);
+
+    // Navigation culling and level of detail, for a perspective camera and a
+    // frameSize framebuffer.  With frustum set only the instances at least
+    // partly inside the view are placed.  Instances projecting to fewer than
+    // minPixels pixels are left out and those projecting to fewer than
+    // lodPixels are replaced by their stand-in.  Returns true if the placed
+    // instances changed and the world handle needs to be committed.
+    bool cullInstances(Node &camera,
+        const vec2i &frameSize,
+        bool frustum,
+        float minPixels,
+        float lodPixels);
+
+    // Places all instances again, returns true if any were culled
+    bool uncullInstances();
+
+    // Whether only part of the instances is placed, and which.  Placed
+    // indices have placedLod set for instances replaced by their stand-in.
+    static constexpr uint32_t placedLod = 0x80000000u;
+
+    inline bool isCulled() const
+    {
+      return culled;
+    }
+
+    inline const std::vector<uint32_t> &placedInstanceIndices() const
+    {
+      return placedInstances;
+    }
+
+   private:
+    void placeInstances(const std::vector<cpp::Instance> &placed);
+
+    box3f cachedBounds{empty};
+    TimeStamp boundsMTime;
+
+    std::vector<cpp::Instance> instances;
+    std::vector<box3f> instanceBounds;
+    std::vector<cpp::Instance> lodInstances;
+    std::vector<int32_t> instanceLods;
+    // Indices of the placed instances while culled
+    std::vector<uint32_t> placedInstances;
+    bool culled{false};
   };
 
   }  // namespace sg
@@ -18,5 +18,20 @@ namespace ospray {
     child("material").setSGOnly();
   }
 
+  box3f Geometry::bounds()
+  {
+    // Skinned positions are updated in place during rendering without
+    // marking the geometry modified, never trust the cache for them.  Only
+    // a committed geometry is asked, until then the last bounds are kept.
+    if ((modifiedSince(boundsMTime) || skin)
+        && !subtreeModifiedButNotCommitted()) {
+      cachedBounds = child("visible").valueAs<bool>()
+          ? handle().getBounds<box3f>()
+          : box3f(empty);
+      boundsMTime.renew();
+    }
+    return cachedBounds;
+  }
+
   }  // namespace sg
 } // namespace ospray
@@ -21,6 +21,11 @@ namespace ospray {
     Geometry(const std::string &osp_type);
     ~Geometry() override = default;
 
+    // OSPRay bounds of the geometry, cached until it is modified.  Doesn't
+    // commit, a geometry modified since its last commit keeps its last
+    // bounds.
+    box3f bounds() override;
+
     // skinning info
     SkinPtr skin;
     NodePtr skeletonRoot;
@@ -30,6 +35,14 @@ namespace ospray {
     std::vector<vec3f> skinnedPositions;
     std::vector<vec3f> normals;
     std::vector<vec3f> skinnedNormals;
+
+    // Simplified stand-in rendered while navigating, see Lod.h.  It isn't part
+    // of the graph, so it is neither traversed nor saved.
+    std::shared_ptr<Geometry> lod;
+
+   private:
+    box3f cachedBounds{empty};
+    TimeStamp boundsMTime;
   };
 
   }  // namespace sg
@@ -0,0 +1,198 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Lod.h"
+// std
+#include <algorithm>
+#include <unordered_map>
+
+namespace ospray {
+  namespace sg {
+
+  namespace {
+
+  inline uint32_t materialOf(
+      const std::vector<uint32_t> &primMaterials, size_t prim)
+  {
+    if (primMaterials.empty())
+      return 0;
+    return prim < primMaterials.size() ? primMaterials[prim] : primMaterials[0];
+  }
+
+  template <typename FCN_T>
+  inline void forEachTriangle(const vec3ui &prim, FCN_T &&fcn)
+  {
+    fcn(prim.x, prim.y, prim.z);
+  }
+
+  template <typename FCN_T>
+  inline void forEachTriangle(const vec4ui &prim, FCN_T &&fcn)
+  {
+    fcn(prim.x, prim.y, prim.z);
+    if (prim.z != prim.w)
+      fcn(prim.x, prim.z, prim.w);
+  }
+
+  std::shared_ptr<Geometry> createMesh(const std::string &name,
+      std::vector<vec3f> &&positions,
+      std::vector<vec3ui> &&triangles,
+      std::vector<uint32_t> &&materials)
+  {
+    auto mesh = createNodeAs<Geometry>(name, "geometry_triangles");
+    mesh->createChildData("vertex.position", std::move(positions));
+    mesh->createChildData("index", std::move(triangles));
+    mesh->createChildData("material", std::move(materials));
+    mesh->child("material").setSGOnly();
+    return mesh;
+  }
+
+  std::shared_ptr<Geometry> createBoxMesh(
+      const std::string &name, const box3f &bounds, uint32_t material)
+  {
+    std::vector<vec3f> corners;
+    corners.reserve(8);
+    for (int i = 0; i < 8; i++) {
+      corners.emplace_back(i & 1 ? bounds.upper.x : bounds.lower.x,
+          i & 2 ? bounds.upper.y : bounds.lower.y,
+          i & 4 ? bounds.upper.z : bounds.lower.z);
+    }
+
+    std::vector<vec3ui> triangles = {{0, 2, 3},
+        {0, 3, 1},
+        {4, 5, 7},
+        {4, 7, 6},
+        {0, 1, 5},
+        {0, 5, 4},
+        {2, 6, 7},
+        {2, 7, 3},
+        {0, 4, 6},
+        {0, 6, 2},
+        {1, 3, 7},
+        {1, 7, 5}};
+
+    return createMesh(name,
+        std::move(corners),
+        std::move(triangles),
+        std::vector<uint32_t>(12, material));
+  }
+
+  template <typename INDEX_T>
+  std::shared_ptr<Geometry> createLod(const std::string &name,
+      const std::vector<vec3f> &positions,
+      const std::vector<INDEX_T> &indices,
+      const std::vector<uint32_t> &primMaterials,
+      int gridSize)
+  {
+    if (positions.empty() || indices.empty() || gridSize < 0)
+      return nullptr;
+
+    box3f bounds(empty);
+    for (auto &p : positions)
+      bounds.extend(p);
+
+    size_t numTriangles = 0;
+    for (auto &prim : indices)
+      forEachTriangle(prim, [&](uint32_t, uint32_t, uint32_t) {
+        numTriangles++;
+      });
+
+    if (gridSize == 0) {
+      if (numTriangles <= 12)
+        return nullptr;
+      return createBoxMesh(name, bounds, materialOf(primMaterials, 0));
+    }
+
+    const float extent = reduce_max(bounds.size());
+    if (!(extent > 0.f))
+      return nullptr;
+
+    // Merge the vertices of every grid cell into their average
+    const float cellsPerUnit = gridSize / extent;
+    std::unordered_map<uint64_t, uint32_t> cellCluster;
+    std::vector<uint32_t> vertexCluster(positions.size());
+    std::vector<vec3f> clusterSum;
+    std::vector<uint32_t> clusterCount;
+
+    for (size_t i = 0; i < positions.size(); i++) {
+      const vec3i cell =
+          min(vec3i((positions[i] - bounds.lower) * cellsPerUnit),
+              vec3i(gridSize - 1));
+      const uint64_t n = gridSize;
+      const uint64_t key = cell.x + n * (cell.y + n * cell.z);
+
+      auto found = cellCluster.find(key);
+      if (found == cellCluster.end()) {
+        found = cellCluster.emplace(key, uint32_t(clusterSum.size())).first;
+        clusterSum.push_back(vec3f(0.f));
+        clusterCount.push_back(0);
+      }
+
+      vertexCluster[i] = found->second;
+      clusterSum[found->second] += positions[i];
+      clusterCount[found->second]++;
+    }
+
+    // Keep the triangles whose corners are still in different clusters, and
+    // only the clusters they use
+    const uint32_t unused = uint32_t(-1);
+    std::vector<uint32_t> clusterVertex(clusterSum.size(), unused);
+    std::vector<vec3f> lodPositions;
+    std::vector<vec3ui> lodTriangles;
+    std::vector<uint32_t> lodMaterials;
+
+    auto vertexOf = [&](uint32_t cluster) {
+      if (clusterVertex[cluster] == unused) {
+        clusterVertex[cluster] = lodPositions.size();
+        lodPositions.push_back(
+            clusterSum[cluster] / float(clusterCount[cluster]));
+      }
+      return clusterVertex[cluster];
+    };
+
+    for (size_t prim = 0; prim < indices.size(); prim++) {
+      forEachTriangle(indices[prim], [&](uint32_t a, uint32_t b, uint32_t c) {
+        if (a >= positions.size() || b >= positions.size()
+            || c >= positions.size())
+          return;
+        a = vertexCluster[a];
+        b = vertexCluster[b];
+        c = vertexCluster[c];
+        if (a == b || b == c || a == c)
+          return;
+        lodTriangles.emplace_back(vertexOf(a), vertexOf(b), vertexOf(c));
+        lodMaterials.push_back(materialOf(primMaterials, prim));
+      });
+    }
+
+    // Not worth it unless the mesh at least halves
+    if (lodTriangles.empty() || 2 * lodTriangles.size() > numTriangles)
+      return nullptr;
+
+    return createMesh(name,
+        std::move(lodPositions),
+        std::move(lodTriangles),
+        std::move(lodMaterials));
+  }
+
+  } // namespace
+
+  std::shared_ptr<Geometry> createLodMesh(const std::string &name,
+      const std::vector<vec3f> &positions,
+      const std::vector<vec3ui> &indices,
+      const std::vector<uint32_t> &primMaterials,
+      int gridSize)
+  {
+    return createLod(name, positions, indices, primMaterials, gridSize);
+  }
+
+  std::shared_ptr<Geometry> createLodMesh(const std::string &name,
+      const std::vector<vec3f> &positions,
+      const std::vector<vec4ui> &indices,
+      const std::vector<uint32_t> &primMaterials,
+      int gridSize)
+  {
+    return createLod(name, positions, indices, primMaterials, gridSize);
+  }
+
+  }  // namespace sg
+} // namespace ospray
@@ -0,0 +1,39 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "Geometry.h"
+
+namespace ospray {
+  namespace sg {
+
+  // Simplified stand-ins for triangle and quad meshes, rendered in place of
+  // the full mesh while navigating, see Geometry::lod.
+  //
+  // With gridSize > 0 the mesh is simplified by vertex clustering: vertices
+  // are merged per cell of a grid with gridSize cells along the longest side
+  // of the mesh bounds and triangles which collapse are dropped.  With
+  // gridSize == 0 the stand-in is the bounding box of the mesh.
+  //
+  // primMaterials are the material IDs of the primitives, or a single ID used
+  // for all of them.  Returns nullptr if the stand-in wouldn't be smaller
+  // than the mesh.
+
+  OSPSG_INTERFACE std::shared_ptr<Geometry> createLodMesh(
+      const std::string &name,
+      const std::vector<vec3f> &positions,
+      const std::vector<vec3ui> &indices,
+      const std::vector<uint32_t> &primMaterials,
+      int gridSize);
+
+  // Quads, triangles in quad meshes repeat their last index
+  OSPSG_INTERFACE std::shared_ptr<Geometry> createLodMesh(
+      const std::string &name,
+      const std::vector<vec3f> &positions,
+      const std::vector<vec4ui> &indices,
+      const std::vector<uint32_t> &primMaterials,
+      int gridSize);
+
+  }  // namespace sg
+} // namespace ospray
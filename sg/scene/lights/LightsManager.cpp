@@ -17,10 +17,16 @@ namespace ospray {
       return NodeType::LIGHTS;
     }
 
-    bool LightsManager::lightExists(std::string name)
+    bool LightsManager::lightExists(const std::string &name) const
     {
-      auto found = std::find(lightNames.begin(), lightNames.end(), name);
-      return (found != lightNames.end());
+      return lightIndex.count(name) != 0;
+    }
+
+    void LightsManager::insertLight(const std::string &name)
+    {
+      lightIndex[name] = lightNames.size();
+      lightNames.push_back(name);
+      lightsChanged = true;
     }
 
     bool LightsManager::addLight(std::string name, std::string lightType)
@@ -28,7 +34,7 @@ namespace ospray {
       if (name == "" || lightExists(name))
         return false;
 
-      lightNames.push_back(name);
+      insertLight(name);
       createChild(name, lightType);
       return true;
     }
@@ -38,20 +44,21 @@ namespace ospray {
       if (lightExists(light->name()))
         return false;
 
-      lightNames.push_back(light->name());
+      insertLight(light->name());
       add(light);
       return true;
     }
 
-    void LightsManager::addLights(std::vector<NodePtr> &lights)
+    size_t LightsManager::addLights(const std::vector<NodePtr> &lights)
     {
-      for (auto &l : lights) {
-        if (lightExists(l->name()))
-          continue;
+      lightNames.reserve(lightNames.size() + lights.size());
+      lightIndex.reserve(lightIndex.size() + lights.size());
 
-        lightNames.push_back(l->name());
-        add(l);
-      }
+      size_t added = 0;
+      for (auto &l : lights)
+        added += addLight(l);
+
+      return added;
     }
 
     bool LightsManager::removeLight(std::string name)
@@ -60,24 +67,39 @@ namespace ospray {
         return false;
 
       remove(name);
-      auto found = std::find(lightNames.begin(), lightNames.end(), name);
-      lightNames.erase(found);
+
+      // Order doesn't matter to the world, fill the gap with the last light
+      auto index = lightIndex[name];
+      if (index != lightNames.size() - 1) {
+        lightNames[index] = std::move(lightNames.back());
+        lightIndex[lightNames[index]] = index;
+      }
+      lightNames.pop_back();
+      lightIndex.erase(name);
+      lightsChanged = true;
 
       return true;
     }
 
     void LightsManager::clear()
     {
-      // removeLight modifies the lightNames vector, make a copy.
-      auto tempNames = lightNames;
-      for (auto &name : tempNames) {
-        removeLight(name);
-      }
+      for (auto &name : lightNames)
+        remove(name);
+
+      lightNames.clear();
+      lightIndex.clear();
+      lightsChanged = true;
     }
 
     void LightsManager::preCommit()
     {
+      // Light handles are stable, the array only changes with the set of
+      // lights
+      if (!lightsChanged)
+        return;
+
       cppLightObjects.clear();
+      cppLightObjects.reserve(lightNames.size());
 
       for (auto &name : lightNames) {
         auto &l = child(name);
@@ -104,14 +126,22 @@ namespace ospray {
         // remove default light
         removeLight("default-ambient");
       }
+      if (currentWorld != &world
+          || currentWorldHandle != world.handle().handle())
+        lightsChanged = true;
       currentWorld = &world;
+      currentWorldHandle = world.handle().handle();
+
       // Commit lightsManager changes then apply lightObjects on the world.
       commit();
 
-      if (!cppLightObjects.empty())
-        world.handle().setParam("light", cpp::CopiedData(cppLightObjects));
-      else
-        world.handle().removeParam("light");
+      if (lightsChanged) {
+        if (!cppLightObjects.empty())
+          world.handle().setParam("light", cpp::CopiedData(cppLightObjects));
+        else
+          world.handle().removeParam("light");
+        lightsChanged = false;
+      }
 
       world.handle().commit();
     }
@@ -5,6 +5,8 @@
 
 #include "../../Node.h"
 #include "../World.h"
+// std
+#include <unordered_map>
 
 namespace ospray {
   namespace sg {
@@ -22,10 +24,12 @@ namespace ospray {
       LightsManager();
       ~LightsManager() override = default;
       NodeType type() const override;
-      bool lightExists(std::string name);
+      bool lightExists(const std::string &name) const;
       bool addLight(std::string name, std::string lightType);
       bool addLight(NodePtr light);
-      void addLights(std::vector<NodePtr> &lights);
+      // Bulk add for importers, skips lights already present and returns how
+      // many were added
+      size_t addLights(const std::vector<NodePtr> &lights);
       bool removeLight(std::string name);
       void clear();
 
@@ -39,13 +43,23 @@ namespace ospray {
 
       protected:
       std::vector<std::string> lightNames;
+      // Position of each light in lightNames
+      std::unordered_map<std::string, size_t> lightIndex;
       std::vector<cpp::Light> cppLightObjects = {};
 
       virtual void preCommit() override;
       virtual void postCommit() override;
 
       private:
+      void insertLight(const std::string &name);
+
       World* currentWorld = nullptr;
+      // Handle of the world the light array was last set on
+      OSPWorld currentWorldHandle{nullptr};
+      // Lights were added or removed since the light array was last passed to
+      // the world.  Editing a light doesn't change its handle, so then only
+      // the world needs a commit.
+      bool lightsChanged{true};
     };
 
   }  // namespace sg
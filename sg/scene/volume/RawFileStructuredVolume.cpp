@@ -2,6 +2,9 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "RawFileStructuredVolume.h"
+// std
+#include <cmath>
+#include <limits>
 
 namespace ospray {
   namespace sg {
@@ -30,5 +33,66 @@ namespace ospray {
 
     return voxels;
   }
+
+  template <typename T>
+  static float quantize(const std::vector<float> &voxels,
+                        std::vector<T> &out,
+                        float scale,
+                        float offset)
+  {
+    const float maxLevel = float(std::numeric_limits<T>::max());
+    out.resize(voxels.size());
+
+    float maxError = 0.f;
+    for (size_t i = 0; i < voxels.size(); i++) {
+      const float v = voxels[i];
+      if (std::isnan(v)) {
+        out[i] = 0;
+        continue;
+      }
+      const float q =
+          std::min(std::max(std::round((v - offset) / scale), 0.f), maxLevel);
+      out[i] = T(q);
+      maxError = std::max(maxError, std::abs(q * scale + offset - v));
+    }
+
+    return maxError;
+  }
+
+  VolumeVoxels quantizeVoxels(std::vector<float> voxels, int bits)
+  {
+    VolumeVoxels result;
+
+    if (bits != 8 && bits != 16) {
+      result.floats = std::move(voxels);
+      return result;
+    }
+
+    float lo = std::numeric_limits<float>::max();
+    float hi = std::numeric_limits<float>::lowest();
+    for (auto v : voxels) {
+      if (!std::isnan(v)) {
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+      }
+    }
+    if (lo > hi)
+      lo = hi = 0.f;
+
+    const float maxLevel = bits == 8 ? 255.f : 65535.f;
+
+    result.bits = bits;
+    result.offset = lo;
+    result.scale = hi > lo ? (hi - lo) / maxLevel : 1.f;
+
+    if (bits == 8)
+      result.maxError =
+          quantize(voxels, result.uchars, result.scale, result.offset);
+    else
+      result.maxError =
+          quantize(voxels, result.ushorts, result.scale, result.offset);
+
+    return result;
+  }
   }  // namespace sg
 } // namespace ospray
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <fstream>
 #include <vector>
 #include "rkcommon/math/vec.h"
@@ -13,6 +14,24 @@ using namespace rkcommon::math;
 namespace ospray {
   namespace sg{
 
+    // Voxels of one volume, either float or quantized to 8/16 bit unsigned
+    // integers.  A quantized voxel q stands for the value q * scale + offset.
+    struct OSPSG_INTERFACE VolumeVoxels
+    {
+      int bits{32};
+      std::vector<float> floats;
+      std::vector<uint8_t> uchars;
+      std::vector<uint16_t> ushorts;
+
+      float scale{1.f};
+      float offset{0.f};
+      float maxError{0.f}; // largest absolute reconstruction error
+    };
+
+    // bits is 8 or 16, anything else keeps the float voxels
+    OSPSG_INTERFACE VolumeVoxels quantizeVoxels(std::vector<float> voxels,
+                                                int bits);
+
     struct OSPSG_INTERFACE RawFileStructuredVolume
     {
       RawFileStructuredVolume(const std::string &filename,
@@ -99,7 +99,7 @@ namespace ospray {
             "wrong format?!)");
       }
 
-      createChildData("data", dimensions, 0, voxels.data());
+      createChildData("data", std::move(voxels), vec3ul(dimensions));
       fclose(file);
       fileLoaded = true;
 
@@ -1,6 +1,8 @@
 // Copyright 2018-2020 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#pragma once
+
 #include <array>
 #include <memory>
 #include <random>
@@ -51,6 +53,13 @@ namespace ospray {
         } 
     }
 
+    // True once createSGVolume() no longer has to wait on reading the file
+    bool isVolumeDataReady() const
+    {
+      return localLoading || sgVolume
+          || (generateVolumeDataTask && generateVolumeDataTask->finished());
+    }
+
     void waitGenerateVolumeData()
     {
       if (localLoading) {
@@ -20,5 +20,17 @@ namespace ospray {
 
   void Volume::load(const FileName &){}
 
+  box3f Volume::bounds()
+  {
+    // Only a committed volume is asked, until then the last bounds are kept
+    if (modifiedSince(boundsMTime) && !subtreeModifiedButNotCommitted()) {
+      cachedBounds = child("visible").valueAs<bool>()
+          ? handle().getBounds<box3f>()
+          : box3f(empty);
+      boundsMTime.renew();
+    }
+    return cachedBounds;
+  }
+
   }  // namespace sg
 } // namespace ospray
@@ -25,6 +25,14 @@ namespace ospray {
 
     NodeType type() const override;
     virtual void load(const FileName &fileName);
+
+    // OSPRay bounds of the volume, cached until it is modified.  Doesn't
+    // commit, a volume modified since its last commit keeps its last bounds.
+    box3f bounds() override;
+
+   private:
+    box3f cachedBounds{empty};
+    TimeStamp boundsMTime;
   };
 
   }  // namespace sg
@@ -1,6 +1,8 @@
 // Copyright 2018-2020 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#pragma once
+
 #include <array>
 #include <memory>
 #include <random>
@@ -49,17 +51,24 @@ namespace ospray {
 
       if (!generateVolumeDataTask) {
         generateVolumeDataTask =
-            std::shared_ptr<tasking::AsyncTask<std::vector<float>>>(
-                new tasking::AsyncTask<std::vector<float>>([=]() {
+            std::shared_ptr<tasking::AsyncTask<VolumeVoxels>>(
+                new tasking::AsyncTask<VolumeVoxels>([=]() {
                   std::shared_ptr<ospray::sg::RawFileStructuredVolume> temp(
                       new ospray::sg::RawFileStructuredVolume(filename,
                                                               dimensions));
 
-                  return temp->generateVoxels();
+                  return quantizeVoxels(temp->generateVoxels(), quantizeBits);
                 }));
       }
     }
 
+    // True once createSGVolume() no longer has to wait on reading the file
+    bool isVolumeDataReady() const
+    {
+      return localLoading || sgVolume
+          || (generateVolumeDataTask && generateVolumeDataTask->finished());
+    }
+
     void waitGenerateVolumeData()
     {
       if (localLoading) {
@@ -86,11 +95,28 @@ namespace ospray {
         sgVolume = std::static_pointer_cast<sg::Volume>(
             createNode("sgVolume_" + to_string(variableNum), "structuredRegular"));
 
+        int sgVoxelType = voxelType;
+
         if (!localLoading) {
-          std::vector<float> voxels(dimensions.long_product());
-          voxels = generateVolumeDataTask->get();
+          auto voxels = generateVolumeDataTask->get();
           generateVolumeDataTask.reset();
-          sgVolume->createChildData("data", dimensions, 0, voxels.data());
+
+          if (voxels.bits == 8) {
+            sgVoxelType = OSP_UCHAR;
+            sgVolume->createChildData(
+                "data", std::move(voxels.uchars), vec3ul(dimensions));
+          } else if (voxels.bits == 16) {
+            sgVoxelType = OSP_USHORT;
+            sgVolume->createChildData(
+                "data", std::move(voxels.ushorts), vec3ul(dimensions));
+          } else {
+            sgVolume->createChildData(
+                "data", std::move(voxels.floats), vec3ul(dimensions));
+          }
+
+          quantizeScale = voxels.scale;
+          quantizeOffset = voxels.offset;
+          quantizeError = voxels.maxError;
         } else {
           sgVolume->nodeAs<sg::StructuredVolume>()->load(filename);
         }
@@ -98,7 +124,7 @@ namespace ospray {
         sgVolume->createChild("dimensions", "vec3i", dimensions);
         sgVolume->createChild("gridOrigin", "vec3f", gridOrigin);
         sgVolume->createChild("gridSpacing", "vec3f", gridSpacing);
-        sgVolume->createChild("voxelType", "int", voxelType);
+        sgVolume->createChild("voxelType", "int", sgVoxelType);
 
         fileLoaded = true;
       }
@@ -116,7 +142,14 @@ namespace ospray {
     bool localLoading{false};
     int variableNum{0};
 
-    std::shared_ptr<tasking::AsyncTask<std::vector<float>>> generateVolumeDataTask;
+    // 8 or 16 to store the voxels quantized, see quantizeVoxels().  The
+    // resulting mapping and error are known once createSGVolume() returns.
+    int quantizeBits{32};
+    float quantizeScale{1.f};
+    float quantizeOffset{0.f};
+    float quantizeError{0.f};
+
+    std::shared_ptr<tasking::AsyncTask<VolumeVoxels>> generateVolumeDataTask;
 
     std::shared_ptr<sg::Volume> sgVolume;
   };
@@ -0,0 +1,38 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "catch/catch.hpp"
+
+#include "sg/Data.h"
+
+using namespace ospray::sg;
+
+SCENARIO("sg::Data taking ownership of a vector")
+{
+  GIVEN("A vector moved into a Data node")
+  {
+    std::vector<float> values(1000, 1.f);
+    const float *buffer = values.data();
+
+    auto root_ptr = createNode("root");
+    auto &root    = *root_ptr;
+    root.createChildData("owned", std::move(values));
+    auto &data = root.childAs<Data>("owned");
+
+    THEN("The buffer is shared instead of copied")
+    {
+      REQUIRE(data.sharedData == buffer);
+      REQUIRE(data.numBytes == 1000 * sizeof(float));
+      REQUIRE(data.ownedData);
+    }
+
+    THEN("The node keeps the buffer alive")
+    {
+      auto owner = data.ownedData;
+      root.remove("owned");
+      REQUIRE(owner.use_count() == 1);
+      REQUIRE(static_cast<const std::vector<float> *>(owner.get())->data()
+          == buffer);
+    }
+  }
+}
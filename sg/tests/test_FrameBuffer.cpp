@@ -0,0 +1,45 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "catch/catch.hpp"
+
+#include "sg/fb/FrameBuffer.h"
+
+using namespace ospray::sg;
+
+SCENARIO("sg::FrameBuffer parameter changes")
+{
+  GIVEN("A committed framebuffer")
+  {
+    auto fb_ptr = createNodeAs<FrameBuffer>("fb", "framebuffer");
+    auto &fb    = *fb_ptr;
+    fb.commit();
+    // Holding a reference keeps a reallocated framebuffer from reusing the
+    // original's handle
+    auto original = fb.handle();
+
+    WHEN("A tone mapper parameter changes")
+    {
+      fb["exposure"] = 2.f;
+      REQUIRE(fb.onlyImageOpsModified());
+      fb.commit();
+
+      THEN("The framebuffer is kept")
+      {
+        REQUIRE(fb.handle().handle() == original.handle());
+      }
+    }
+
+    WHEN("The size changes")
+    {
+      fb["size"] = vec2i(64, 32);
+      REQUIRE(!fb.onlyImageOpsModified());
+      fb.commit();
+
+      THEN("The framebuffer is reallocated")
+      {
+        REQUIRE(fb.handle().handle() != original.handle());
+      }
+    }
+  }
+}
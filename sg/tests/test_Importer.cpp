@@ -0,0 +1,84 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "catch/catch.hpp"
+
+#include "sg/importer/Importer.h"
+
+using namespace ospray::sg;
+
+SCENARIO("sg::Importer deferred import")
+{
+  GIVEN("An OBJ importer deferred with the bounds of its model")
+  {
+    const rkcommon::FileName objFile(TEST_DATA_DIR "/test_deferred.obj");
+
+    auto registry =
+        createNodeAs<MaterialRegistry>("registry", "materialRegistry");
+    auto world = createNode("world", "world");
+    auto importer = getImporter(world, objFile);
+    REQUIRE(importer);
+    importer->setMaterialRegistry(registry);
+
+    const box3f bounds(vec3f(0.f), vec3f(1.f, 1.f, 0.f));
+    importer->deferImport(bounds);
+    auto &rootXfm = importer->child("test_deferred_rootXfm");
+
+    auto camera = createNode("camera", "camera_perspective");
+
+    THEN("Its root transform holds a stand-in until the model is imported")
+    {
+      REQUIRE(importer->isDeferred());
+      REQUIRE(importer->modelBounds() == bounds);
+      REQUIRE(rootXfm.hasChild("test_deferred_standIn"));
+      REQUIRE(deferredImports.size() == 1);
+
+      rootXfm["translation"] = vec3f(1.f);
+      REQUIRE(importNextDeferred(*camera, true));
+
+      REQUIRE(!importer->isDeferred());
+      REQUIRE(&importer->child("test_deferred_rootXfm") == &rootXfm);
+      REQUIRE(!rootXfm.hasChild("test_deferred_standIn"));
+      REQUIRE(rootXfm["translation"].valueAs<vec3f>() == vec3f(1.f));
+      REQUIRE(importer->modelBounds() == bounds);
+      // Bounds are those of the last commit
+      importer->commit();
+      importer->updateModelBounds();
+      REQUIRE(importer->modelBounds() == bounds);
+      REQUIRE(!importNextDeferred(*camera, true));
+    }
+
+    THEN("A stand-in out of view isn't imported")
+    {
+      camera->child("position") = vec3f(0.f, 0.f, 10.f);
+      camera->child("direction") = vec3f(0.f, 0.f, 1.f);
+      REQUIRE(!importNextDeferred(*camera));
+      REQUIRE(importer->isDeferred());
+
+      camera->child("direction") = vec3f(0.f, 0.f, -1.f);
+      REQUIRE(importNextDeferred(*camera));
+      REQUIRE(!importer->isDeferred());
+    }
+
+    THEN("Instances share the stand-in, then the model")
+    {
+      REQUIRE(getImporter(world, objFile) == nullptr);
+      auto &instanceXfm = world->child("test_deferred_instanceXfm_1");
+      REQUIRE(instanceXfm.hasChild("test_deferred_standIn"));
+      REQUIRE(!instanceXfm.hasChild("test_deferred_rootXfm"));
+
+      // Only the instance is in view
+      instanceXfm = affine3f::translate(vec3f(0.f, 0.f, 20.f));
+      camera->child("position") = vec3f(0.f, 0.f, 10.f);
+      camera->child("direction") = vec3f(0.f, 0.f, 1.f);
+      REQUIRE(importNextDeferred(*camera));
+
+      REQUIRE(!instanceXfm.hasChild("test_deferred_standIn"));
+      REQUIRE(instanceXfm.children().size() == rootXfm.children().size());
+      for (auto &c : rootXfm.children())
+        REQUIRE(&instanceXfm.child(c.first) == c.second.get());
+    }
+
+    clearAssets();
+  }
+}
@@ -0,0 +1,59 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "catch/catch.hpp"
+
+#include "sg/scene/lights/LightsManager.h"
+
+using namespace ospray::sg;
+
+SCENARIO("sg::LightsManager membership")
+{
+  GIVEN("A lights manager with a few lights added in bulk")
+  {
+    auto lights_ptr = createNodeAs<LightsManager>("lights", "lights");
+    auto &lights    = *lights_ptr;
+
+    std::vector<NodePtr> newLights;
+    for (int i = 0; i < 4; i++)
+      newLights.push_back(createNode("light" + std::to_string(i), "sphere"));
+
+    REQUIRE(lights.addLights(newLights) == 4);
+    REQUIRE(lights.addLights(newLights) == 0);
+
+    WHEN("A light in the middle is removed")
+    {
+      REQUIRE(lights.removeLight("light1"));
+
+      THEN("The remaining lights are still found")
+      {
+        REQUIRE(!lights.lightExists("light1"));
+        REQUIRE(!lights.hasChild("light1"));
+        REQUIRE(lights.lightExists("light0"));
+        REQUIRE(lights.lightExists("light2"));
+        REQUIRE(lights.lightExists("light3"));
+        REQUIRE(lights.hasChild("light3"));
+      }
+
+      THEN("The light moved into its place can be removed")
+      {
+        REQUIRE(lights.removeLight("light3"));
+        REQUIRE(!lights.removeLight("light3"));
+        REQUIRE(lights.lightExists("light0"));
+        REQUIRE(lights.lightExists("light2"));
+      }
+    }
+
+    WHEN("The manager is cleared")
+    {
+      lights.clear();
+
+      THEN("No lights remain")
+      {
+        REQUIRE(!lights.lightExists("light0"));
+        REQUIRE(!lights.hasChildren());
+        REQUIRE(lights.addLights(newLights) == 4);
+      }
+    }
+  }
+}
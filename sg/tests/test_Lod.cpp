@@ -0,0 +1,53 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "catch/catch.hpp"
+
+#include "sg/Data.h"
+#include "sg/scene/geometry/Lod.h"
+
+using namespace ospray::sg;
+
+SCENARIO("sg::createLodMesh()")
+{
+  GIVEN("A finely tessellated square")
+  {
+    const uint32_t n = 32;
+    std::vector<vec3f> positions;
+    for (uint32_t y = 0; y <= n; y++)
+      for (uint32_t x = 0; x <= n; x++)
+        positions.emplace_back(x / float(n), y / float(n), 0.f);
+
+    std::vector<vec4ui> quads;
+    for (uint32_t y = 0; y < n; y++) {
+      for (uint32_t x = 0; x < n; x++) {
+        const uint32_t i = y * (n + 1) + x;
+        quads.emplace_back(i, i + 1, i + n + 2, i + n + 1);
+      }
+    }
+
+    auto triangles = [](Geometry &mesh) {
+      return static_cast<Data &>(mesh["index"]).numBytes / sizeof(vec3ui);
+    };
+
+    THEN("Vertex clustering keeps far fewer triangles")
+    {
+      auto lod = createLodMesh("lod", positions, quads, {3}, 4);
+      REQUIRE(lod);
+      REQUIRE(triangles(*lod) > 0);
+      REQUIRE(triangles(*lod) <= 2 * 5 * 5);
+    }
+
+    THEN("A grid size of 0 makes a box")
+    {
+      auto lod = createLodMesh("lod", positions, quads, {3}, 0);
+      REQUIRE(lod);
+      REQUIRE(triangles(*lod) == 12);
+    }
+
+    THEN("A grid as fine as the mesh isn't worth a stand-in")
+    {
+      REQUIRE(!createLodMesh("lod", positions, quads, {3}, 64));
+    }
+  }
+}
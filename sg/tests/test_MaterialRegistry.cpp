@@ -0,0 +1,100 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "catch/catch.hpp"
+
+#include "sg/renderer/MaterialRegistry.h"
+
+using namespace ospray::sg;
+
+SCENARIO("sg::MaterialRegistry list updates")
+{
+  GIVEN("A material registry with its list built")
+  {
+    auto registry_ptr =
+        createNodeAs<MaterialRegistry>("registry", "materialRegistry");
+    auto &registry = *registry_ptr;
+
+    REQUIRE(registry.updateMaterialList("scivis"));
+    REQUIRE(registry.cppMaterialList.size() == 1);
+    auto handle = registry.cppMaterialList[0].handle();
+
+    THEN("Editing a material keeps the list")
+    {
+      registry["sgDefault"]["kd"] = vec3f(0.2f);
+      REQUIRE(!registry.updateMaterialList("scivis"));
+      REQUIRE(registry.cppMaterialList[0].handle() == handle);
+    }
+
+    THEN("Adding a material rebuilds the list")
+    {
+      registry.add(createNode("added", "obj"));
+      REQUIRE(registry.updateMaterialList("scivis"));
+      REQUIRE(registry.cppMaterialList.size() == 2);
+      REQUIRE(registry.cppMaterialList[0].handle() == handle);
+    }
+
+    THEN("Changing the renderer rebuilds the list")
+    {
+      REQUIRE(registry.updateMaterialList("pathtracer"));
+      REQUIRE(registry.cppMaterialList[0].handle() != handle);
+    }
+
+    THEN("Switching back to a renderer type reuses its list")
+    {
+      REQUIRE(registry.updateMaterialList("pathtracer"));
+      REQUIRE(!registry.updateMaterialList("scivis"));
+      REQUIRE(registry.cppMaterialList[0].handle() == handle);
+    }
+
+    THEN("Lists of other renderer types are rebuilt after adding a material")
+    {
+      REQUIRE(registry.updateMaterialList("pathtracer"));
+      registry.add(createNode("added", "obj"));
+      REQUIRE(registry.updateMaterialList("pathtracer"));
+      REQUIRE(registry.updateMaterialList("scivis"));
+      REQUIRE(registry.cppMaterialList.size() == 2);
+      REQUIRE(registry.cppMaterialList[0].handle() == handle);
+    }
+  }
+}
+
+SCENARIO("sg::MaterialRegistry material de-duplication")
+{
+  GIVEN("A de-duplicating registry with one imported material")
+  {
+    auto registry_ptr =
+        createNodeAs<MaterialRegistry>("registry", "materialRegistry");
+    auto &registry = *registry_ptr;
+    registry.deduplicate = true;
+
+    auto red = createNode("red", "obj");
+    red->child("kd") = vec3f(1.f, 0.f, 0.f);
+    auto ids = registry.addMaterials({red});
+    REQUIRE(ids == std::vector<uint32_t>{1});
+
+    THEN("An identical material of another import is merged")
+    {
+      auto red2 = createNode("red2", "obj");
+      red2->child("kd") = vec3f(1.f, 0.f, 0.f);
+      auto green = createNode("green", "obj");
+      green->child("kd") = vec3f(0.f, 1.f, 0.f);
+
+      ids = registry.addMaterials({red2, green});
+      REQUIRE(ids == std::vector<uint32_t>{1, 2});
+      REQUIRE(registry.mergedMaterials == 1);
+      REQUIRE(!registry.hasChild("red2"));
+    }
+
+    THEN("An edited material is no longer merged")
+    {
+      registry["red"]["kd"] = vec3f(0.5f, 0.f, 0.f);
+
+      auto red2 = createNode("red2", "obj");
+      red2->child("kd") = vec3f(1.f, 0.f, 0.f);
+      ids = registry.addMaterials({red2});
+      REQUIRE(ids == std::vector<uint32_t>{2});
+      REQUIRE(registry.mergedMaterials == 0);
+    }
+  }
+}
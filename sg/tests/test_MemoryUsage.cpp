@@ -0,0 +1,44 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "catch/catch.hpp"
+
+#include "sg/visitors/MemoryUsage.h"
+
+using namespace ospray::sg;
+
+SCENARIO("sg::MemoryUsage")
+{
+  GIVEN("A tree with copied and shared arrays")
+  {
+    const std::vector<float> values(1000, 1.f);
+
+    auto root_ptr = createNode("root");
+    auto &root    = *root_ptr;
+    auto &a       = root.createChild("a");
+    auto &b       = root.createChild("b");
+    a.createChildData("copied", values);
+    a.createChildData("shared", values, true);
+    b.createChildData("sharedAgain", values, true);
+
+    // a node with two parents
+    auto &c = a.createChild("c");
+    c.createChildData("copied", values);
+    b.add(c);
+
+    MemoryUsage usage;
+    root.traverse(usage);
+
+    THEN("Every buffer is counted once")
+    {
+      const size_t bytes = values.size() * sizeof(float);
+      REQUIRE(usage.totalBytes == 3 * bytes);
+      REQUIRE(usage.bytesByType[NodeType::PARAMETER] == 3 * bytes);
+      REQUIRE(usage.nodes[&root].subtreeBytes == 3 * bytes);
+      REQUIRE(usage.nodes[&a].subtreeBytes == 3 * bytes);
+      REQUIRE(usage.nodes[&b].subtreeBytes == 0);
+      REQUIRE(usage.nodes[&c].subtreeBytes == bytes);
+      REQUIRE(usage.largest(1)[0].node == &root);
+    }
+  }
+}
@@ -261,6 +261,61 @@ SCENARIO("sg::Node structural updates")
   }
 }
 
+SCENARIO("sg::Node dirty lists")
+{
+  GIVEN("A committed tree")
+  {
+    auto root_ptr = createNode("root");
+    auto &root    = *root_ptr;
+    auto &a       = root.createChild("a");
+    auto &b       = root.createChild("b");
+    auto &a0      = a.createChild("a0");
+
+    root.commit();
+
+    THEN("Dirty lists are empty")
+    {
+      REQUIRE(root.properties.dirtyChildren.empty());
+      REQUIRE(a.properties.dirtyChildren.empty());
+    }
+
+    WHEN("A leaf is modified twice")
+    {
+      a0 = 1;
+      a0 = 2;
+
+      THEN("Only its path to the root is queued, once")
+      {
+        REQUIRE(root.properties.dirtyChildren.size() == 1);
+        REQUIRE(root.properties.dirtyChildren[0] == &a);
+        REQUIRE(a.properties.dirtyChildren.size() == 1);
+        REQUIRE(a.properties.dirtyChildren[0] == &a0);
+        REQUIRE(b.properties.dirtyChildren.empty());
+      }
+
+      THEN("Committing the root commits the leaf and clears the lists")
+      {
+        root.commit();
+        REQUIRE(!root.isModified());
+        REQUIRE(a0.lastModified() < a0.lastCommitted());
+        REQUIRE(root.properties.dirtyChildren.empty());
+        REQUIRE(a.properties.dirtyChildren.empty());
+      }
+    }
+
+    WHEN("A modified child is removed")
+    {
+      a0 = 1;
+      root.remove("a");
+
+      THEN("It is no longer queued")
+      {
+        REQUIRE(root.properties.dirtyChildren.empty());
+      }
+    }
+  }
+}
+
 SCENARIO("sg::Node_T<> interface")
 {
   GIVEN("A freshly created sg::FloatNode")
@@ -0,0 +1,122 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "catch/catch.hpp"
+
+#include "sg/NodeIndex.h"
+
+using namespace ospray::sg;
+
+SCENARIO("sg::NodeIndex")
+{
+  GIVEN("A small tree and its index")
+  {
+    auto root_ptr = createNode("root");
+    auto &root    = *root_ptr;
+    auto &a       = root.createChild("a");
+    auto &b       = root.createChild("b");
+    auto &a0      = a.createChild("a0");
+    a.createChild("a1", "float", 1.f);
+
+    NodeIndex index;
+    REQUIRE(index.update(root));
+
+    THEN("Nodes are found by path and unique ID")
+    {
+      REQUIRE(index.size() == 4);
+      REQUIRE(index.find("a").get() == &a);
+      REQUIRE(index.find("a/a0").get() == &a0);
+      REQUIRE(index.find("b").get() == &b);
+      REQUIRE(index.find("a/b") == nullptr);
+      REQUIRE(index.findByID(a0.uniqueID()).get() == &a0);
+    }
+
+    THEN("Nodes are enumerated by type and path prefix")
+    {
+      auto params = index.findByType(NodeType::PARAMETER);
+      REQUIRE(params.size() == 1);
+      REQUIRE(params[0].first == "a/a1");
+
+      auto underA = index.findByPrefix("a/");
+      REQUIRE(underA.size() == 2);
+      REQUIRE(underA[0].first == "a/a0");
+      REQUIRE(underA[1].first == "a/a1");
+
+      REQUIRE(index.findByPrefix("a/a").size() == 2);
+      REQUIRE(index.findByPrefix("c").empty());
+    }
+
+    THEN("Nodes are found by name anywhere below the root")
+    {
+      auto &b_a0 = b.createChild("a0");
+      b.createChild("mesh_0001");
+      REQUIRE(index.update(root));
+
+      auto named = index.findByName("a0");
+      REQUIRE(named.size() == 2);
+      REQUIRE(named[0].second.get() == &a0);
+      REQUIRE(named[1].second.get() == &b_a0);
+      REQUIRE(index.findByName("a").size() == 1);
+
+      auto prefixed = index.findByNamePrefix("a");
+      REQUIRE(prefixed.size() == 4);
+      REQUIRE(prefixed[0].first == "a");
+      REQUIRE(prefixed[1].first == "a/a0");
+      REQUIRE(prefixed[2].first == "a/a1");
+      REQUIRE(prefixed[3].first == "b/a0");
+
+      REQUIRE(index.findByNamePrefix("mesh_00").size() == 1);
+      REQUIRE(index.findByNamePrefix("mesh_1").empty());
+    }
+
+    THEN("Value changes don't require an update")
+    {
+      a0 = 3.f;
+      REQUIRE(!index.update(root));
+    }
+
+    WHEN("A child is added to an inner node")
+    {
+      auto &b0 = b.createChild("b0");
+
+      THEN("The index picks up the new node")
+      {
+        REQUIRE(index.update(root));
+        REQUIRE(index.size() == 5);
+        REQUIRE(index.find("b/b0").get() == &b0);
+      }
+    }
+
+    WHEN("A subtree is removed")
+    {
+      const auto id = a0.uniqueID();
+      root.remove("a");
+
+      THEN("All of its paths are dropped")
+      {
+        REQUIRE(index.update(root));
+        REQUIRE(index.size() == 1);
+        REQUIRE(index.find("a") == nullptr);
+        REQUIRE(index.find("a/a0") == nullptr);
+        REQUIRE(index.findByID(id) == nullptr);
+        REQUIRE(index.findByType(NodeType::PARAMETER).empty());
+        REQUIRE(index.findByName("a0").empty());
+      }
+    }
+
+    WHEN("A child is replaced by another node of the same name")
+    {
+      auto other = createNode("a0");
+      other->createChild("c");
+      a.add(other);
+
+      THEN("The old subtree is replaced")
+      {
+        REQUIRE(index.update(root));
+        REQUIRE(index.find("a/a0") == other);
+        REQUIRE(index.find("a/a0/c") != nullptr);
+        REQUIRE(index.size() == 5);
+      }
+    }
+  }
+}
@@ -0,0 +1,76 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "catch/catch.hpp"
+
+#include "sg/NodeSnapshot.h"
+
+using namespace ospray::sg;
+
+SCENARIO("sg::NodeSnapshot")
+{
+  GIVEN("A small tree and its snapshot")
+  {
+    auto root_ptr = createNode("root");
+    auto &root    = *root_ptr;
+    auto &a       = root.createChild("a");
+    auto &b       = root.createChild("b");
+    a.createChild("a0");
+    a.createChild("a1");
+
+    NodeSnapshot snapshot;
+    REQUIRE(snapshot.update(root));
+
+    THEN("Records are in traversal order with contiguous subtrees")
+    {
+      auto &r = snapshot.records();
+      REQUIRE(r.size() == 5);
+      REQUIRE(r[0].node == &root);
+      REQUIRE(r[0].subtreeSize == 5);
+      REQUIRE(r[1].node == &a);
+      REQUIRE(r[1].subtreeSize == 3);
+      REQUIRE(r[2].parent == 1);
+      REQUIRE(r[3].parent == 1);
+      REQUIRE(r[4].node == &b);
+      REQUIRE(r[4].parent == 0);
+      REQUIRE(r[4].level == 1);
+    }
+
+    THEN("Value changes don't require a rebuild")
+    {
+      b = 3.f;
+      REQUIRE(!snapshot.update(root));
+    }
+
+    WHEN("A child is added to an inner node")
+    {
+      b.createChild("b0");
+
+      THEN("The snapshot is rebuilt and reflects the change")
+      {
+        REQUIRE(snapshot.update(root));
+        auto &r = snapshot.records();
+        REQUIRE(r.size() == 6);
+        REQUIRE(r[1].node == &a);
+        REQUIRE(r[4].node == &b);
+        REQUIRE(r[4].subtreeSize == 2);
+        REQUIRE(r[5].parent == 4);
+      }
+    }
+
+    WHEN("A child is removed")
+    {
+      a.remove("a0");
+
+      THEN("The snapshot is rebuilt and reflects the change")
+      {
+        REQUIRE(snapshot.update(root));
+        auto &r = snapshot.records();
+        REQUIRE(r.size() == 4);
+        REQUIRE(r[1].subtreeSize == 2);
+        REQUIRE(r[3].node == &b);
+        REQUIRE(r[3].parent == 0);
+      }
+    }
+  }
+}
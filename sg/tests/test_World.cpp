@@ -0,0 +1,62 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "catch/catch.hpp"
+
+#include "sg/scene/World.h"
+
+using namespace ospray::sg;
+
+SCENARIO("sg::World navigation culling")
+{
+  GIVEN("A world with an instance in view, one behind and a tiny one")
+  {
+    auto world_ptr = createNodeAs<World>("world", "world");
+    auto &world = *world_ptr;
+
+    std::vector<cpp::Instance> instances(3, cpp::Instance(cpp::Group()));
+    std::vector<cpp::Instance> lodInstances(1, cpp::Instance(cpp::Group()));
+    world.setInstances(std::move(instances),
+        {box3f(vec3f(-1.f, -1.f, 9.f), vec3f(1.f, 1.f, 11.f)),
+            box3f(vec3f(-1.f, -1.f, -11.f), vec3f(1.f, 1.f, -9.f)),
+            box3f(vec3f(0.f, 0.f, 100.f), vec3f(0.001f, 0.001f, 100.001f))},
+        std::move(lodInstances),
+        {0, -1, -1});
+
+    auto camera_ptr = createNode("camera", "camera_perspective");
+    auto &camera = *camera_ptr;
+    camera["position"] = vec3f(0.f);
+    camera["direction"] = vec3f(0.f, 0.f, 1.f);
+
+    THEN("Only the instance in view and large enough is placed")
+    {
+      REQUIRE(world.cullInstances(camera, vec2i(512), true, 1.f, 0.f));
+      REQUIRE(world.placedInstanceIndices() == std::vector<uint32_t>{0});
+      REQUIRE(!world.cullInstances(camera, vec2i(512), true, 1.f, 0.f));
+
+      REQUIRE(world.cullInstances(camera, vec2i(512), true, 0.f, 0.f));
+      REQUIRE(world.placedInstanceIndices() == std::vector<uint32_t>{0, 2});
+    }
+
+    THEN("Without the frustum test the instance behind is kept")
+    {
+      REQUIRE(world.cullInstances(camera, vec2i(512), false, 1.f, 0.f));
+      REQUIRE(world.placedInstanceIndices() == std::vector<uint32_t>{0, 1});
+    }
+
+    THEN("Instances small on screen are replaced by their stand-in")
+    {
+      REQUIRE(world.cullInstances(camera, vec2i(512), true, 1.f, 1000.f));
+      REQUIRE(world.placedInstanceIndices()
+          == std::vector<uint32_t>{0 | World::placedLod});
+    }
+
+    THEN("Unculling places every instance again")
+    {
+      REQUIRE(!world.uncullInstances());
+      REQUIRE(world.cullInstances(camera, vec2i(512), true, 1.f, 0.f));
+      REQUIRE(world.uncullInstances());
+      REQUIRE(!world.isCulled());
+    }
+  }
+}
@@ -0,0 +1,107 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "catch/catch.hpp"
+
+#include "sg/importer/glTF/meshopt_decoder.h"
+// std
+#include <vector>
+
+using namespace ospray::sg;
+
+SCENARIO("sg::decodeMeshopt()")
+{
+  GIVEN("A vertex stream of 4 byte vertices")
+  {
+    // Header, 4 byte streams of a header and a group each, then the tail
+    // ending in the vertex the deltas are relative to
+    std::vector<uint8_t> stream = {0xa0};
+    const uint8_t deltas[4] = {2, 3, 6, 0}; // zigzag of 1, -2, 3, 0
+    for (auto d : deltas) {
+      stream.push_back(0x03); // a group of raw bytes
+      stream.push_back(d);
+      stream.insert(stream.end(), 15, 0);
+    }
+    stream.insert(stream.end(), 28, 0);
+    stream.insert(stream.end(), {10, 20, 30, 40});
+
+    THEN("The vertex is decoded relative to the tail")
+    {
+      uint8_t vertex[4];
+      REQUIRE(decodeMeshopt(
+          vertex, 1, 4, stream.data(), stream.size(), "ATTRIBUTES"));
+      REQUIRE(vertex[0] == 11);
+      REQUIRE(vertex[1] == 18);
+      REQUIRE(vertex[2] == 33);
+      REQUIRE(vertex[3] == 40);
+    }
+
+    THEN("A truncated stream is rejected")
+    {
+      uint8_t vertex[4];
+      REQUIRE(!decodeMeshopt(
+          vertex, 1, 4, stream.data(), stream.size() - 1, "ATTRIBUTES"));
+    }
+  }
+
+  GIVEN("A vertex stream of zero deltas and the exponential filter")
+  {
+    std::vector<uint8_t> stream = {0xa0, 0, 0, 0, 0};
+    stream.insert(stream.end(), 28, 0);
+    stream.insert(stream.end(), {3, 0, 0, 0xff}); // 3 * 2^-1
+
+    THEN("The filter makes floats of the mantissa and exponent")
+    {
+      float value;
+      REQUIRE(decodeMeshopt((uint8_t *)&value,
+          1,
+          4,
+          stream.data(),
+          stream.size(),
+          "ATTRIBUTES",
+          "EXPONENTIAL"));
+      REQUIRE(value == 1.5f);
+    }
+  }
+
+  GIVEN("Index streams")
+  {
+    THEN("Triangles are decoded from new vertices and recent edges")
+    {
+      // A triangle of new vertices coded in the table, then one on its
+      // last edge with a new vertex
+      std::vector<uint8_t> stream = {0xe1, 0xf0, 0x00};
+      stream.insert(stream.end(), 16, 0);
+
+      uint32_t indices[6];
+      REQUIRE(decodeMeshopt((uint8_t *)indices,
+          6,
+          4,
+          stream.data(),
+          stream.size(),
+          "TRIANGLES"));
+      REQUIRE(indices[0] == 0);
+      REQUIRE(indices[1] == 1);
+      REQUIRE(indices[2] == 2);
+      REQUIRE(indices[3] == 0);
+      REQUIRE(indices[4] == 2);
+      REQUIRE(indices[5] == 3);
+    }
+
+    THEN("Index sequences are decoded from deltas")
+    {
+      const std::vector<uint8_t> stream = {0xd1, 20, 4, 4, 0, 0, 0, 0};
+
+      uint16_t indices[3];
+      REQUIRE(decodeMeshopt((uint8_t *)indices,
+          3,
+          2,
+          stream.data(),
+          stream.size(),
+          "INDICES"));
+      REQUIRE(indices[0] == 5);
+      REQUIRE(indices[1] == 6);
+      REQUIRE(indices[2] == 7);
+    }
+  }
+}
@@ -9,6 +9,7 @@ OIIO_NAMESPACE_USING
 #endif
 
 #include "Texture2D.h"
+#include "../Profiler.h"
 
 #include "rkcommon/memory/malloc.h"
 
@@ -270,6 +271,7 @@ namespace ospray {
     if (textureCache.find(fileName) != textureCache.end()) {
       newTexNode = textureCache[fileName];
     } else {
+      SG_PROFILE_SCOPE("texture decode", fileName.str());
 
       newTexNode = createNodeAs<sg::Texture2D>(fileName, "texture_2d");
 
@@ -33,6 +33,7 @@ namespace ospray {
   inline void CommitVisitor::postChildren(Node &node, TraversalContext &)
   {
     if (node.subtreeModifiedButNotCommitted()) {
+      node.properties.dirtyChildren.clear();
       node.postCommit();
       node.properties.lastCommitted.renew();
     }
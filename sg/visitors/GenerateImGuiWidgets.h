@@ -8,6 +8,8 @@
 #include "imgui_internal.h"
 
 #include <stack>
+#include <unordered_map>
+#include <vector>
 
 static bool g_ShowTooltips = true;
 static int g_TooltipDelay = 500; // ms delay
@@ -38,6 +40,43 @@ struct GenerateImGuiWidgets : public Visitor
   bool &updated;
 };
 
+// Virtualized counterpart of GenerateImGuiWidgets for lists of very many
+// nodes.  The visible part of the tree is flattened to rows of equal height,
+// collapsed subtrees are never entered and only the rows inside the scroll
+// region generate widgets.  Rows are only collected again when the roots,
+// the structure below them or the open state change.  Use inside a
+// scrolling child window.
+struct TreeView
+{
+  TreeView(TreeState state = TreeState::ALLCLOSED);
+
+  // Returns the root whose subtree the user changed, or nullptr
+  Node *draw(const std::vector<Node *> &roots);
+
+ private:
+  struct Row
+  {
+    Node *node;
+    int level;
+    int root;
+    int affinePart; // -1, or which line of an affine3f widget
+  };
+
+  bool rowsOutdated(const std::vector<Node *> &roots) const;
+  void collectRows(Node &node, int level, int root);
+  void addAffineRows(Node &node, int level, int root);
+  bool isOpen(Node &node, int level);
+  bool drawRow(const Row &row);
+
+  TreeState initState;
+  std::unordered_map<size_t, bool> openState; // by Node::uniqueID()
+  bool openStateChanged{false};
+
+  std::vector<Row> rows;
+  std::vector<Node *> rowRoots; // roots the rows were collected for
+  TimeStamp rowsCollected;
+};
+
 inline void showTooltip(std::string message)
 {
   if (g_ShowTooltips && ImGui::IsItemHovered()
@@ -450,5 +489,164 @@ inline void GenerateImGuiWidgets::postChildren(Node &, TraversalContext &ctx)
   }
 }
 
+inline TreeView::TreeView(TreeState state) : initState(state) {}
+
+inline Node *TreeView::draw(const std::vector<Node *> &roots)
+{
+  if (openStateChanged || rowsOutdated(roots)) {
+    rows.clear();
+    for (size_t i = 0; i < roots.size(); i++)
+      collectRows(*roots[i], 0, i);
+    rowRoots = roots;
+    rowsCollected.renew();
+    openStateChanged = false;
+  }
+
+  Node *updatedRoot = nullptr;
+
+  ImGuiListClipper clipper(
+      int(rows.size()), ImGui::GetFrameHeightWithSpacing());
+  while (clipper.Step()) {
+    for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+      const auto &row = rows[i];
+      const float indent = row.level * ImGui::GetStyle().IndentSpacing;
+
+      ImGui::PushID(row.node);
+      if (indent > 0.f)
+        ImGui::Indent(indent);
+
+      // Keep text rows as high as framed widgets so all rows are equal
+      ImGui::AlignTextToFramePadding();
+      if (drawRow(row) && !updatedRoot)
+        updatedRoot = roots[row.root];
+
+      if (indent > 0.f)
+        ImGui::Unindent(indent);
+      ImGui::PopID();
+    }
+  }
+
+  return updatedRoot;
+}
+
+inline bool TreeView::rowsOutdated(const std::vector<Node *> &roots) const
+{
+  if (roots != rowRoots)
+    return true;
+
+  for (auto *root : roots) {
+    if (root->structureLastModified() > rowsCollected)
+      return true;
+  }
+
+  return false;
+}
+
+inline void TreeView::collectRows(Node &node, int level, int root)
+{
+  auto generator = widgetGenerators.find(node.subType());
+
+  if (generator != widgetGenerators.end()) {
+    if (node.subType() == "affine3f")
+      addAffineRows(node, level, root);
+    else
+      rows.push_back({&node, level, root, -1});
+    // as in GenerateImGuiWidgets, children of parameters are not indented
+    for (auto &child : node.children())
+      collectRows(*child.second, level, root);
+  } else if (node.hasChildren()) {
+    rows.push_back({&node, level, root, -1});
+    if (isOpen(node, level)) {
+      if (node.type() == NodeType::TRANSFORM)
+        addAffineRows(node, level + 1, root);
+      for (auto &child : node.children())
+        collectRows(*child.second, level + 1, root);
+    }
+  } else {
+    rows.push_back({&node, level, root, -1});
+  }
+}
+
+inline void TreeView::addAffineRows(Node &node, int level, int root)
+{
+  // read-only values are a single line of text
+  const int numParts = node.readOnly() ? 1 : 6;
+  for (int part = 0; part < numParts; part++)
+    rows.push_back({&node, level, root, part});
+}
+
+inline bool TreeView::isOpen(Node &node, int level)
+{
+  auto found = openState.find(node.uniqueID());
+  if (found != openState.end())
+    return found->second;
+
+  return initState == TreeState::ALLOPEN
+      || (initState == TreeState::ROOTOPEN && level == 0);
+}
+
+inline bool TreeView::drawRow(const Row &row)
+{
+  auto &node = *row.node;
+
+  if (row.affinePart >= 0 && node.readOnly())
+    return generateWidget_affine3f(node.name(), node);
+
+  if (row.affinePart >= 0) {
+    affine3f a = node.valueAs<affine3f>();
+    bool changed = false;
+    switch (row.affinePart) {
+    case 0:
+      ImGui::Text("%s", "linear space");
+      break;
+    case 1:
+      changed = ImGui::DragFloat3("l.vx", a.l.vx);
+      break;
+    case 2:
+      changed = ImGui::DragFloat3("l.vy", a.l.vy);
+      break;
+    case 3:
+      changed = ImGui::DragFloat3("l.vz", a.l.vz);
+      break;
+    case 4:
+      ImGui::Text("%s", "affine space");
+      break;
+    case 5:
+      changed = ImGui::DragFloat3("p", a.p);
+      break;
+    }
+    nodeTooltip(node);
+    if (changed)
+      node.setValue(a);
+    return changed;
+  }
+
+  std::string widgetName = node.name();
+
+  auto generator = widgetGenerators.find(node.subType());
+  if (generator != widgetGenerators.end()) {
+    widgetName += "##" + std::to_string(node.uniqueID());
+    return generator->second(widgetName, node);
+  } else if (node.hasChildren()) {
+    const bool open = isOpen(node, row.level);
+    ImGui::SetNextItemOpen(open);
+    // Rows are indented by the view, not by the tree node
+    const bool toggled = ImGui::TreeNodeEx(widgetName.c_str(),
+                             ImGuiTreeNodeFlags_NoTreePushOnOpen)
+        != open;
+    if (toggled) {
+      openState[node.uniqueID()] = !open;
+      openStateChanged = true;
+    }
+    nodeTooltip(node);
+  } else {
+    widgetName += ": " + node.subType();
+    ImGui::Text("%s", widgetName.c_str());
+    nodeTooltip(node);
+  }
+
+  return false;
+}
+
 } // namespace sg
 } // namespace ospray
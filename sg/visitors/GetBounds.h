@@ -14,27 +14,16 @@ namespace ospray {
 
     bool operator()(Node &node, TraversalContext &ctx) override;
 
-    box3f bounds;
+    box3f bounds{empty};
   };
 
   // Inlined definitions //////////////////////////////////////////////////////
 
   inline bool GetBounds::operator()(Node &node, TraversalContext &)
   {
-    switch (node.type()) {
-    case NodeType::WORLD: {
-      auto world = node.valueAs<cpp::World>();
-      bounds     = world.getBounds<box3f>();
-      return false;
-    }
-    case NodeType::GEOMETRY: {
-      auto geom = node.valueAs<cpp::Geometry>();
-      bounds    = geom.getBounds<box3f>();
-      return false;
-    }
-    default:
-      return true;
-    }
+    // Nodes keep their subtree bounds cached, no need to go further down
+    bounds.extend(node.bounds());
+    return false;
   }
 
   }  // namespace sg
@@ -0,0 +1,194 @@
+// Copyright 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "../Data.h"
+#include "../fb/FrameBuffer.h"
+#include "../scene/geometry/Geometry.h"
+// std
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ospray {
+namespace sg {
+
+// Bytes held by a (sub)graph: Data arrays, the vertex copies geometries keep
+// for skinning, framebuffer channels and pick buffers.  Every buffer is
+// counted once, by the first node it is reached from, whether it is a node
+// with several parents or application memory wrapped by a shared Data array.
+
+struct MemoryUsage : public Visitor
+{
+  struct NodeUsage
+  {
+    const Node *node{nullptr};
+    size_t bytes{0}; // held by the node itself
+    size_t subtreeBytes{0}; // the node and everything counted below it
+  };
+
+  MemoryUsage() = default;
+  ~MemoryUsage() override = default;
+
+  bool operator()(Node &node, TraversalContext &ctx) override;
+  void postChildren(Node &node, TraversalContext &ctx) override;
+
+  // The n largest subtrees
+  std::vector<NodeUsage> largest(size_t n) const;
+
+  void print(std::ostream &out, size_t n = 10) const;
+
+  std::unordered_map<const Node *, NodeUsage> nodes;
+  std::map<NodeType, size_t> bytesByType;
+  size_t totalBytes{0};
+
+ private:
+  size_t count(const void *buffer, size_t bytes);
+
+  template <typename T>
+  size_t count(const std::vector<T> &v);
+
+  std::unordered_set<const void *> counted;
+  // Subtree bytes of the nodes being traversed, nullptr for a node which was
+  // already reached through another parent
+  std::vector<std::pair<const Node *, size_t>> stack;
+};
+
+inline std::string formatBytes(size_t bytes)
+{
+  const char *units[] = {"B", "KB", "MB", "GB", "TB"};
+  double value = bytes;
+  int unit = 0;
+  while (value >= 1024.0 && unit < 4) {
+    value /= 1024.0;
+    unit++;
+  }
+
+  char text[32];
+  std::snprintf(text, sizeof(text), unit ? "%.1f %s" : "%.0f %s", value,
+      units[unit]);
+  return text;
+}
+
+// Inlined definitions //////////////////////////////////////////////////////
+
+inline bool MemoryUsage::operator()(Node &node, TraversalContext &)
+{
+  if (nodes.count(&node)) {
+    stack.emplace_back(nullptr, 0);
+    return false;
+  }
+
+  size_t bytes = 0;
+
+  if (auto *data = dynamic_cast<Data *>(&node)) {
+    bytes += count(
+        data->sharedData ? data->sharedData : (const void *)data,
+        data->numBytes);
+  } else if (auto *geom = dynamic_cast<Geometry *>(&node)) {
+    bytes += count(geom->positions);
+    bytes += count(geom->skinnedPositions);
+    bytes += count(geom->normals);
+    bytes += count(geom->skinnedNormals);
+    bytes += count(geom->joints);
+    bytes += count(geom->weights);
+    if (geom->skin)
+      bytes += count(geom->skin->inverseBindMatrices);
+    if (geom->lod) {
+      for (auto &c : geom->lod->children()) {
+        if (auto *data = dynamic_cast<Data *>(c.second.get())) {
+          bytes += count(
+              data->sharedData ? data->sharedData : (const void *)data,
+              data->numBytes);
+        }
+      }
+    }
+  } else if (auto *fb = dynamic_cast<FrameBuffer *>(&node)) {
+    bytes += count(fb, fb->memoryUsage());
+  }
+
+  auto &usage = nodes[&node];
+  usage.node = &node;
+  usage.bytes = bytes;
+
+  if (bytes)
+    bytesByType[node.type()] += bytes;
+  totalBytes += bytes;
+
+  stack.emplace_back(&node, bytes);
+  return true;
+}
+
+inline void MemoryUsage::postChildren(Node &, TraversalContext &)
+{
+  auto top = stack.back();
+  stack.pop_back();
+
+  if (!top.first)
+    return;
+
+  nodes[top.first].subtreeBytes = top.second;
+  if (!stack.empty())
+    stack.back().second += top.second;
+}
+
+inline std::vector<MemoryUsage::NodeUsage> MemoryUsage::largest(
+    size_t n) const
+{
+  std::vector<NodeUsage> result;
+  result.reserve(nodes.size());
+  for (auto &usage : nodes)
+    result.push_back(usage.second);
+
+  n = std::min(n, result.size());
+  std::partial_sort(result.begin(),
+      result.begin() + n,
+      result.end(),
+      [](const NodeUsage &a, const NodeUsage &b) {
+        return a.subtreeBytes > b.subtreeBytes;
+      });
+  result.resize(n);
+
+  return result;
+}
+
+inline void MemoryUsage::print(std::ostream &out, size_t n) const
+{
+  out << "memory usage: " << formatBytes(totalBytes) << std::endl;
+
+  out << "  by node type:" << std::endl;
+  for (auto &t : bytesByType) {
+    out << "    " << std::left << std::setw(20) << NodeTypeToString[t.first]
+        << std::right << std::setw(12) << formatBytes(t.second) << std::endl;
+  }
+
+  out << "  largest subtrees:" << std::endl;
+  for (auto &usage : largest(n)) {
+    if (!usage.subtreeBytes)
+      break;
+    out << "    " << std::left << std::setw(40) << usage.node->name()
+        << std::right << std::setw(12) << formatBytes(usage.subtreeBytes)
+        << " (own " << formatBytes(usage.bytes) << ")" << std::endl;
+  }
+}
+
+inline size_t MemoryUsage::count(const void *buffer, size_t bytes)
+{
+  if (!buffer || !bytes || !counted.insert(buffer).second)
+    return 0;
+  return bytes;
+}
+
+template <typename T>
+inline size_t MemoryUsage::count(const std::vector<T> &v)
+{
+  return count(v.data(), v.size() * sizeof(T));
+}
+
+} // namespace sg
+} // namespace ospray
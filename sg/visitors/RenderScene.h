@@ -4,8 +4,10 @@
 #pragma once
 
 #include "../Node.h"
+#include "../Profiler.h"
 #include "../renderer/MaterialRegistry.h"
 #include "../scene/Transform.h"
+#include "../scene/World.h"
 #include "../scene/geometry/Geometry.h"
 #include "../scene/lights/Light.h"
 // std
@@ -38,6 +40,9 @@ namespace ospray {
       std::vector<cpp::GeometricModel> geometries;
       std::vector<cpp::VolumetricModel> volumes;
       std::vector<cpp::GeometricModel> clippingGeometries;
+      // geometries, with their stand-ins where they have one
+      std::vector<cpp::GeometricModel> lodGeometries;
+      bool hasLod{false};
       // make this a shared pointer instead of vector
       std::vector<cpp::Texture> textures;
       // make this a shared pointer instead of vector
@@ -50,7 +55,11 @@ namespace ospray {
     } current;
     bool setTextureVolume{false};
     cpp::World world;
+    World *worldNode{nullptr};
     std::vector<cpp::Instance> instances;
+    std::vector<box3f> instanceBounds;
+    std::vector<cpp::Instance> lodInstances;
+    std::vector<int32_t> instanceLods;
     std::stack<affine3f> xfms;
     std::stack<uint32_t> materialIDs;
     std::stack<cpp::TransferFunction> tfns;
@@ -82,6 +91,7 @@ namespace ospray {
     switch (node.type()) {
     case NodeType::WORLD:
       world = node.valueAs<cpp::World>();
+      worldNode = node.nodeAs<World>().get();
       // XXX Can this be set only when in navMode?
       world.setParam("dynamicScene", true);
       break;
@@ -100,12 +110,8 @@ namespace ospray {
       tfns.push(node.valueAs<cpp::TransferFunction>());
       break;
     case NodeType::TRANSFORM: {
-      affine3f xfm =
-          affine3f::rotate(node.child("rotation").valueAs<quaternionf>())
-          * affine3f::scale(node.child("scale").valueAs<vec3f>());
-      xfm.p = node.child("translation").valueAs<vec3f>();
       auto xfmNode = node.nodeAs<Transform>();
-      xfmNode->accumulatedXfm = xfms.top() * xfm * node.valueAs<affine3f>();
+      xfmNode->accumulatedXfm = xfms.top() * xfmNode->localXfm();
       xfms.push(xfmNode->accumulatedXfm);
       // special Ids overwrite all id writing implementations
       if (node.hasChild("instanceID") && !useCustomIds){
@@ -133,7 +139,10 @@ namespace ospray {
     case NodeType::WORLD:
       createInstanceFromGroup();
       placeInstancesInWorld();
-      world.commit();
+      {
+        SG_PROFILE_SCOPE("ospCommit world");
+        world.commit();
+      }
       break;
     case NodeType::GEOMETRY:
       createGeometry(node);
@@ -227,9 +236,22 @@ namespace ospray {
     }
 
     model.commit();
-    if (!node.child("isClipping").valueAs<bool>())
+    if (!node.child("isClipping").valueAs<bool>()) {
       current.geometries.push_back(model);
-    else
+      // Skinned meshes move, their stand-in wouldn't follow
+      if (geomNode->lod && !geomNode->skin) {
+        auto &lod = *geomNode->lod;
+        if (lod.subtreeModifiedButNotCommitted())
+          lod.commit();
+        cpp::GeometricModel lodModel(lod.valueAs<cpp::Geometry>());
+        lodModel.setParam(
+            "material", lod["material"].valueAs<cpp::CopiedData>());
+        lodModel.commit();
+        current.lodGeometries.push_back(lodModel);
+        current.hasLod = true;
+      } else
+        current.lodGeometries.push_back(model);
+    } else
       current.clippingGeometries.push_back(model);
   }
 
@@ -302,19 +324,48 @@ namespace ospray {
       group.setParam(
           "clippingGeometry", cpp::CopiedData(current.clippingGeometries));
 
-    current.geometries.clear();
-    current.volumes.clear();
-    current.clippingGeometries.clear();
+    // Clipping geometry affects everything in view, never cull it
+    const bool neverCull = !current.clippingGeometries.empty();
 
     // XXX Can this be set only when in navMode?
     group.setParam("dynamicScene", true);
 
-    group.commit();
+    {
+      SG_PROFILE_SCOPE("ospCommit group");
+      group.commit();
+    }
 
     cpp::Instance inst(group);
     inst.setParam("xfm", xfms.top());
     inst.commit();
     instances.push_back(inst);
+    instanceBounds.push_back(neverCull
+            ? box3f(empty)
+            : xfmBounds(xfms.top(), group.getBounds<box3f>()));
+
+    // The same group with the geometries' stand-ins, placed instead while
+    // navigating if the instance is small on screen
+    if (current.hasLod && !neverCull) {
+      cpp::Group lodGroup;
+      lodGroup.setParam("geometry", cpp::CopiedData(current.lodGeometries));
+      if (!current.volumes.empty())
+        lodGroup.setParam("volume", cpp::CopiedData(current.volumes));
+      lodGroup.setParam("dynamicScene", true);
+      lodGroup.commit();
+
+      cpp::Instance lodInst(lodGroup);
+      lodInst.setParam("xfm", xfms.top());
+      lodInst.commit();
+      instanceLods.push_back(lodInstances.size());
+      lodInstances.push_back(lodInst);
+    } else
+      instanceLods.push_back(-1);
+
+    current.geometries.clear();
+    current.volumes.clear();
+    current.clippingGeometries.clear();
+    current.lodGeometries.clear();
+    current.hasLod = false;
 
     if (in != nullptr && !instanceId.empty()) {
       auto ospInstance = inst.handle();
@@ -354,6 +405,13 @@ namespace ospray {
       world.setParam("instance", cpp::CopiedData(instances));
     else
       world.removeParam("instance");
+
+    // Kept by the world for navigation culling
+    if (worldNode)
+      worldNode->setInstances(std::move(instances),
+          std::move(instanceBounds),
+          std::move(lodInstances),
+          std::move(instanceLods));
   }
 
   }  // namespace sg
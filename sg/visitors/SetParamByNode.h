@@ -4,6 +4,7 @@
 #pragma once
 
 #include "../Node.h"
+#include "../NodeIndex.h"
 #include "rkcommon/utility/Any.h"
 
 #include <string>
@@ -28,6 +29,14 @@ namespace ospray {
       rkcommon::utility::Any value;
     };
 
+    // Same as traversing with SetParamByNode, but only visits the nodes of
+    // the type found in an up to date index of the graph.  Unlike the visitor
+    // it also sets nodes of the type nested below a matching node.
+    void setParamByNode(const NodeIndex &index,
+                        NodeType targetType,
+                        const std::string &targetParam,
+                        rkcommon::utility::Any targetValue);
+
     // Inlined definitions ////////////////////////////////////////////////////
 
     inline bool SetParamByNode::operator()(Node &node,
@@ -40,5 +49,14 @@ namespace ospray {
       
       return true;
     }
+
+    inline void setParamByNode(const NodeIndex &index,
+                               NodeType targetType,
+                               const std::string &targetParam,
+                               rkcommon::utility::Any targetValue)
+    {
+      for (auto &node : index.findByType(targetType))
+        node.second->child(targetParam).setValue(targetValue);
+    }
   }  // namespace sg
 }  // namespace ospray